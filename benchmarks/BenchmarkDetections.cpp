@@ -0,0 +1,407 @@
+//
+// Copyright 2023 BMW AG
+// SPDX-License-Identifier: MPL-2.0
+//
+
+/*
+ * Benchmark of the detection checks on synthetic point clouds
+ *
+ * A lidar and a radar frame with the given number of detections (default
+ * 2 million) are generated, every 1000th detection lacks one of its
+ * required fields.  Each frame is checked repeatedly like in the FMU
+ * (CheckDetectionArrays followed by the detection loops) and the fastest
+ * and median run are reported.  For comparison, a loop that only loads the
+ * position of every detection shows the cost of walking the parsed
+ * messages, and parsing the serialized frame is timed as well, since it has
+ * to happen before any check.  A scan of the serialized frame on the wire
+ * format, which checks the same fields without building the messages, shows
+ * how far the checks are from the time it takes to read the frame once.
+ *
+ * Usage: BenchmarkDetections [detections] [repetitions]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/wire_format_lite.h>
+
+#include "FieldChecks.h"
+
+namespace
+{
+
+typedef std::chrono::steady_clock Clock;
+using google::protobuf::io::CodedInputStream;
+using google::protobuf::internal::WireFormatLite;
+
+/* Keeps a result alive without printing it, so the timed loops are not removed as dead code */
+template <typename T>
+void DoNotOptimize(const T& value)
+{
+  static volatile T sink;
+  sink = value;
+}
+
+struct Timings
+{
+  std::vector<double> milliseconds;
+
+  void Add(Clock::time_point start) { milliseconds.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count()); }
+  double Fastest() const { return *std::min_element(milliseconds.begin(), milliseconds.end()); }
+  double Median() const
+  {
+    std::vector<double> sorted = milliseconds;
+    std::sort(sorted.begin(), sorted.end());
+    return sorted[sorted.size() / 2];
+  }
+};
+
+template <typename Detection>
+void FillDetection(Detection* detection, int index)
+{
+  if (index % 1000 != 1)
+  {
+    detection->mutable_position()->set_distance(1.0 + 0.001 * (index % 100000));
+    detection->mutable_position()->set_azimuth(0.0001 * (index % 31416));
+    detection->mutable_position()->set_elevation(0.0);
+  }
+  if (index % 1000 != 2)
+  {
+    detection->set_existence_probability(0.9);
+  }
+}
+
+osi3::SensorData LidarFrame(int detection_count)
+{
+  osi3::SensorData sensor_data;
+  osi3::LidarDetectionData* lidar_sensor = sensor_data.mutable_feature_data()->add_lidar_sensor();
+  lidar_sensor->mutable_detection()->Reserve(detection_count);
+  for (int i = 0; i < detection_count; i++)
+  {
+    osi3::LidarDetection* detection = lidar_sensor->add_detection();
+    FillDetection(detection, i);
+    if (i % 1000 != 3)
+    {
+      detection->set_intensity(0.5);
+    }
+  }
+  return sensor_data;
+}
+
+osi3::SensorData RadarFrame(int detection_count)
+{
+  osi3::SensorData sensor_data;
+  osi3::RadarDetectionData* radar_sensor = sensor_data.mutable_feature_data()->add_radar_sensor();
+  radar_sensor->mutable_detection()->Reserve(detection_count);
+  for (int i = 0; i < detection_count; i++)
+  {
+    osi3::RadarDetection* detection = radar_sensor->add_detection();
+    FillDetection(detection, i);
+    if (i % 1000 != 3)
+    {
+      detection->set_rcs(10.0);
+    }
+  }
+  return sensor_data;
+}
+
+/* The checks of one frame as run by the FMU without step time budget */
+FieldCheckMask CheckDetections(const osi3::FeatureData& feature_data, FieldCheckMask enabled_checks, FieldCounts& counts)
+{
+  FieldCheckMask missing = CheckDetectionArrays(feature_data, enabled_checks, counts);
+  for (const auto& lidar_sensor : feature_data.lidar_sensor())
+  {
+    missing |= CheckLidarDetections(lidar_sensor, 0, lidar_sensor.detection_size(), enabled_checks, counts);
+  }
+  for (const auto& radar_sensor : feature_data.radar_sensor())
+  {
+    missing |= CheckRadarDetections(radar_sensor, 0, radar_sensor.detection_size(), enabled_checks, counts);
+  }
+  return missing;
+}
+
+/* Lower bound of the detection loops: every detection and its position is loaded once */
+template <typename SensorData>
+double SumDistances(const SensorData& sensors)
+{
+  double sum = 0.0;
+  for (const auto& sensor : sensors)
+  {
+    for (const auto& detection : sensor.detection())
+    {
+      sum += detection.position().distance();
+    }
+  }
+  return sum;
+}
+
+/* Field numbers of the wire format scan, looked up by name so they follow the linked OSI version */
+struct WireFields
+{
+  int feature_data;
+  int sensor;
+  int detection;
+  int position;
+  int distance;
+  int azimuth;
+  int elevation;
+  int value;
+  int existence_probability;
+  FieldCheck array_check;
+  FieldCheck position_check;
+  FieldCheck value_check;
+  FieldCheck existence_probability_check;
+};
+
+int FieldNumber(const google::protobuf::Descriptor* message, const char* name)
+{
+  return message->FindFieldByName(name)->number();
+}
+
+WireFields LidarWireFields()
+{
+  const google::protobuf::Descriptor* detection = osi3::LidarDetection::descriptor();
+  const google::protobuf::Descriptor* position = osi3::Spherical3d::descriptor();
+  return WireFields{FieldNumber(osi3::SensorData::descriptor(), "feature_data"),
+                    FieldNumber(osi3::FeatureData::descriptor(), "lidar_sensor"),
+                    FieldNumber(osi3::LidarDetectionData::descriptor(), "detection"),
+                    FieldNumber(detection, "position"),
+                    FieldNumber(position, "distance"),
+                    FieldNumber(position, "azimuth"),
+                    FieldNumber(position, "elevation"),
+                    FieldNumber(detection, "intensity"),
+                    FieldNumber(detection, "existence_probability"),
+                    kCheckLidarDetection,
+                    kCheckLidarDetectionPosition,
+                    kCheckLidarDetectionIntensity,
+                    kCheckLidarDetectionExistenceProbability};
+}
+
+WireFields RadarWireFields()
+{
+  const google::protobuf::Descriptor* detection = osi3::RadarDetection::descriptor();
+  const google::protobuf::Descriptor* position = osi3::Spherical3d::descriptor();
+  return WireFields{FieldNumber(osi3::SensorData::descriptor(), "feature_data"),
+                    FieldNumber(osi3::FeatureData::descriptor(), "radar_sensor"),
+                    FieldNumber(osi3::RadarDetectionData::descriptor(), "detection"),
+                    FieldNumber(detection, "position"),
+                    FieldNumber(position, "distance"),
+                    FieldNumber(position, "azimuth"),
+                    FieldNumber(position, "elevation"),
+                    FieldNumber(detection, "rcs"),
+                    FieldNumber(detection, "existence_probability"),
+                    kCheckRadarDetection,
+                    kCheckRadarDetectionPosition,
+                    kCheckRadarDetectionRcs,
+                    kCheckRadarDetectionExistenceProbability};
+}
+
+bool IsField(uint32_t tag, int number, WireFormatLite::WireType wire_type)
+{
+  return WireFormatLite::GetTagFieldNumber(tag) == number && WireFormatLite::GetTagWireType(tag) == wire_type;
+}
+
+bool ReadDouble(CodedInputStream& input, double& value)
+{
+  uint64_t bits = 0;
+  const bool read = input.ReadLittleEndian64(&bits);
+  std::memcpy(&value, &bits, sizeof(value));
+  return read;
+}
+
+/* Calls scan for the content of a length-delimited field, which is a nested message */
+template <typename Scan>
+bool ScanMessage(CodedInputStream& input, Scan scan)
+{
+  int size = 0;
+  if (!input.ReadVarintSizeAsInt(&size))
+  {
+    return false;
+  }
+  const CodedInputStream::Limit limit = input.PushLimit(size);
+  const bool scanned = scan() && input.ConsumedEntireMessage();
+  input.PopLimit(limit);
+  return scanned;
+}
+
+/* Reads the fields of a message up to the current limit, calls field for every tag and skips the fields it does not handle */
+template <typename Field>
+bool ScanFields(CodedInputStream& input, Field field)
+{
+  while (const uint32_t tag = input.ReadTag())
+  {
+    bool handled = false;
+    if (!field(tag, handled) || (!handled && !WireFormatLite::SkipField(&input, tag)))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+/* A present double field is valid when its last value on the wire is finite */
+bool ScanDouble(CodedInputStream& input, uint32_t tag, int number, bool& present, bool& finite, bool& handled)
+{
+  if (!IsField(tag, number, WireFormatLite::WIRETYPE_FIXED64))
+  {
+    return true;
+  }
+  double value = 0.0;
+  handled = true;
+  present = true;
+  const bool read = ReadDouble(input, value);
+  finite = std::isfinite(value);
+  return read;
+}
+
+bool ScanDetection(CodedInputStream& input, const WireFields& fields, FieldCounts& counts)
+{
+  bool has_position = false;
+  bool position_finite[3] = {true, true, true};
+  bool has_value = false;
+  bool value_finite = false;
+  bool has_existence_probability = false;
+  bool existence_probability_finite = false;
+  const bool scanned = ScanFields(input, [&](uint32_t tag, bool& handled) {
+    if (IsField(tag, fields.position, WireFormatLite::WIRETYPE_LENGTH_DELIMITED))
+    {
+      /* Repeated occurrences of a message field are merged, so every component keeps its last value */
+      handled = true;
+      has_position = true;
+      return ScanMessage(input, [&]() {
+        return ScanFields(input, [&](uint32_t position_tag, bool& position_handled) {
+          bool present = false;
+          return ScanDouble(input, position_tag, fields.distance, present, position_finite[0], position_handled) &&
+                 ScanDouble(input, position_tag, fields.azimuth, present, position_finite[1], position_handled) &&
+                 ScanDouble(input, position_tag, fields.elevation, present, position_finite[2], position_handled);
+        });
+      });
+    }
+    return ScanDouble(input, tag, fields.value, has_value, value_finite, handled) &&
+           ScanDouble(input, tag, fields.existence_probability, has_existence_probability, existence_probability_finite, handled);
+  });
+  counts.checked[fields.position_check]++;
+  counts.checked[fields.value_check]++;
+  counts.checked[fields.existence_probability_check]++;
+  counts.missing[fields.position_check] += static_cast<uint64_t>(!(has_position & position_finite[0] & position_finite[1] & position_finite[2]));
+  counts.missing[fields.value_check] += static_cast<uint64_t>(!(has_value & value_finite));
+  counts.missing[fields.existence_probability_check] += static_cast<uint64_t>(!(has_existence_probability & existence_probability_finite));
+  return scanned;
+}
+
+/* The detection checks of CheckDetections on the serialized frame, returns false if the frame is malformed */
+bool ScanDetections(const std::string& serialized, const WireFields& fields, FieldCounts& counts)
+{
+  CodedInputStream input(reinterpret_cast<const uint8_t*>(serialized.data()), static_cast<int>(serialized.size()));
+  bool any_sensor = false;
+  bool empty_sensor = false;
+  const bool scanned = ScanFields(input, [&](uint32_t tag, bool& handled) {
+    if (!IsField(tag, fields.feature_data, WireFormatLite::WIRETYPE_LENGTH_DELIMITED))
+    {
+      return true;
+    }
+    handled = true;
+    return ScanMessage(input, [&]() {
+      return ScanFields(input, [&](uint32_t sensor_tag, bool& sensor_handled) {
+        if (!IsField(sensor_tag, fields.sensor, WireFormatLite::WIRETYPE_LENGTH_DELIMITED))
+        {
+          return true;
+        }
+        sensor_handled = true;
+        uint64_t detections = 0;
+        const bool sensor_scanned = ScanMessage(input, [&]() {
+          return ScanFields(input, [&](uint32_t detection_tag, bool& detection_handled) {
+            if (!IsField(detection_tag, fields.detection, WireFormatLite::WIRETYPE_LENGTH_DELIMITED))
+            {
+              return true;
+            }
+            detection_handled = true;
+            detections++;
+            return ScanMessage(input, [&]() { return ScanDetection(input, fields, counts); });
+          });
+        });
+        any_sensor = true;
+        empty_sensor = empty_sensor || detections == 0;
+        return sensor_scanned;
+      });
+    });
+  });
+  counts.checked[fields.array_check]++;
+  counts.missing[fields.array_check] += static_cast<uint64_t>(!any_sensor || empty_sensor);
+  return scanned;
+}
+
+bool Run(const char* name, const osi3::SensorData& frame, FieldCheckMask enabled_checks, const WireFields& wire_fields, int detection_count, int repetitions)
+{
+  const std::string serialized = frame.SerializeAsString();
+  osi3::SensorData parsed;
+  Timings parse;
+  Timings check;
+  Timings traverse;
+  Timings scan;
+  FieldCounts counts;
+  FieldCounts scan_counts;
+  bool scanned = true;
+  for (int repetition = 0; repetition < repetitions; repetition++)
+  {
+    Clock::time_point start = Clock::now();
+    parsed.ParseFromString(serialized);
+    parse.Add(start);
+
+    counts = FieldCounts();
+    start = Clock::now();
+    DoNotOptimize(CheckDetections(parsed.feature_data(), enabled_checks, counts));
+    check.Add(start);
+
+    start = Clock::now();
+    DoNotOptimize(SumDistances(parsed.feature_data().lidar_sensor()) + SumDistances(parsed.feature_data().radar_sensor()));
+    traverse.Add(start);
+
+    scan_counts = FieldCounts();
+    start = Clock::now();
+    scanned = ScanDetections(serialized, wire_fields, scan_counts) && scanned;
+    scan.Add(start);
+  }
+
+  uint64_t missing = 0;
+  bool scan_matches = scanned;
+  for (int i = 0; i < kFieldCheckCount; i++)
+  {
+    missing += counts.missing[i];
+    scan_matches = scan_matches && counts.checked[i] == scan_counts.checked[i] && counts.missing[i] == scan_counts.missing[i];
+  }
+  std::cout << std::fixed << std::setprecision(2) << name << ": " << detection_count << " detections (" << static_cast<double>(serialized.size()) / 1e6 << " MB), check "
+            << check.Fastest() << " ms fastest, " << check.Median() << " ms median (" << check.Fastest() * 1e6 / detection_count << " ns per detection), traversal only "
+            << traverse.Fastest() << " ms, parse " << parse.Fastest() << " ms, wire format scan " << scan.Fastest() << " ms, " << missing << " missing fields found" << std::endl;
+  if (!scan_matches)
+  {
+    std::cerr << name << ": the counts of the wire format scan differ from the checks" << std::endl;
+  }
+  return scan_matches;
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  const int detection_count = (argc > 1) ? std::atoi(argv[1]) : 2000000;
+  const int repetitions = (argc > 2) ? std::atoi(argv[2]) : 10;
+  if (detection_count <= 0 || repetitions <= 0)
+  {
+    std::cerr << "Usage: " << argv[0] << " [detections] [repetitions]" << std::endl;
+    return 2;
+  }
+
+  /* One frame at a time, a frame of 2 million detections takes a few hundred MB */
+  const bool lidar_matches = Run("lidar", LidarFrame(detection_count), kLidarChecks, LidarWireFields(), detection_count, repetitions);
+  const bool radar_matches = Run("radar", RadarFrame(detection_count), kRadarChecks, RadarWireFields(), detection_count, repetitions);
+  return (lidar_matches && radar_matches) ? 0 : 1;
+}
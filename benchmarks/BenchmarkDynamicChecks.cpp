@@ -0,0 +1,200 @@
+//
+// Copyright 2023 BMW AG
+// SPDX-License-Identifier: MPL-2.0
+//
+
+/*
+ * Benchmark of the runtime-loaded descriptor checks against the generated code
+ *
+ * Synthetic SensorData frames with moving objects and lidar detections are
+ * checked for all field checks of the FMU, once parsed into the generated
+ * OSI classes and checked with CheckSensorDataFields, once parsed into a
+ * dynamic message and checked by reflection with DynamicFieldChecker like
+ * with the fmi parameter descriptor_set.  The descriptor set of the linked
+ * OSI version is written to the given file first.  Both paths are timed
+ * including parsing, and the missing fields found are printed per path.
+ *
+ * Usage: BenchmarkDynamicChecks [descriptor_set=osi_sensordata.desc] [frames=100] [objects=200] [detections=20000]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <google/protobuf/descriptor.pb.h>
+
+#include "DynamicFieldChecker.h"
+#include "FieldChecks.h"
+
+namespace
+{
+
+typedef std::chrono::steady_clock Clock;
+
+double Milliseconds(Clock::duration duration)
+{
+  return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+/* Files in dependency order, as protoc --include_imports writes them */
+void AddFile(const google::protobuf::FileDescriptor* file, std::set<std::string>& added, google::protobuf::FileDescriptorSet& descriptor_set)
+{
+  if (!added.insert(file->name()).second)
+  {
+    return;
+  }
+  for (int i = 0; i < file->dependency_count(); i++)
+  {
+    AddFile(file->dependency(i), added, descriptor_set);
+  }
+  file->CopyTo(descriptor_set.add_file());
+}
+
+bool WriteDescriptorSet(const std::string& path)
+{
+  google::protobuf::FileDescriptorSet descriptor_set;
+  std::set<std::string> added;
+  AddFile(osi3::SensorData::descriptor()->file(), added, descriptor_set);
+  std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+  return descriptor_set.SerializeToOstream(&file) && file.good();
+}
+
+void FillVector(osi3::Vector3d* vector, double value)
+{
+  vector->set_x(value);
+  vector->set_y(-value);
+  vector->set_z(0.5 * value);
+}
+
+/* Every 50th object and every 1000th detection lack one field */
+std::string Frame(int frame_index, int object_count, int detection_count)
+{
+  osi3::SensorData sensor_data;
+  sensor_data.mutable_timestamp()->set_seconds(frame_index);
+  for (int i = 0; i < object_count; i++)
+  {
+    osi3::BaseMoving* base = sensor_data.add_moving_object()->mutable_base();
+    base->mutable_dimension()->set_length(4.5);
+    base->mutable_dimension()->set_width(1.8);
+    base->mutable_dimension()->set_height(1.5);
+    FillVector(base->mutable_position(), 10.0 + i);
+    if (i % 50 != 7)
+    {
+      FillVector(base->mutable_velocity(), 1.0);
+    }
+    FillVector(base->mutable_acceleration(), 0.1);
+    base->mutable_orientation()->set_yaw(0.1);
+    base->mutable_orientation_rate()->set_yaw(0.0);
+    base->mutable_orientation_acceleration()->set_yaw(0.0);
+    for (int corner = 0; corner < 4; corner++)
+    {
+      base->add_base_polygon()->set_x(corner);
+    }
+  }
+  osi3::LidarDetectionData* lidar_sensor = sensor_data.mutable_feature_data()->add_lidar_sensor();
+  for (int i = 0; i < detection_count; i++)
+  {
+    osi3::LidarDetection* detection = lidar_sensor->add_detection();
+    detection->mutable_position()->set_distance(1.0 + 0.01 * i);
+    detection->mutable_position()->set_azimuth(0.0);
+    detection->mutable_position()->set_elevation(0.0);
+    detection->set_existence_probability(0.9);
+    if (i % 1000 != 3)
+    {
+      detection->set_intensity(0.5);
+    }
+  }
+  return sensor_data.SerializeAsString();
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  const std::string descriptor_set_path = (argc > 1) ? argv[1] : "osi_sensordata.desc";
+  const int frame_count = (argc > 2) ? std::atoi(argv[2]) : 100;
+  const int object_count = (argc > 3) ? std::atoi(argv[3]) : 200;
+  const int detection_count = (argc > 4) ? std::atoi(argv[4]) : 20000;
+  if (argc > 5 || frame_count <= 0 || object_count < 0 || detection_count < 0)
+  {
+    std::cerr << "Usage: " << argv[0] << " [descriptor_set] [frames] [objects] [detections]" << std::endl;
+    return 2;
+  }
+
+  if (!WriteDescriptorSet(descriptor_set_path))
+  {
+    std::cerr << "cannot write " << descriptor_set_path << std::endl;
+    return 1;
+  }
+  std::string error;
+  DynamicFieldChecker dynamic_checker;
+  if (!dynamic_checker.Load(descriptor_set_path, "osi3.SensorData", error))
+  {
+    std::cerr << error << std::endl;
+    return 1;
+  }
+  dynamic_checker.SetFieldPaths(std::set<std::string>(kFieldCheckNames, kFieldCheckNames + kFieldCheckCount));
+  const FieldCheckMask enabled_checks = (1ULL << static_cast<unsigned>(kFieldCheckCount)) - 1U;
+
+  std::vector<std::string> frames;
+  size_t total_bytes = 0;
+  for (int i = 0; i < frame_count; i++)
+  {
+    frames.push_back(Frame(i, object_count, detection_count));
+    total_bytes += frames.back().size();
+  }
+
+  /* Generated code, the message is reused for all frames like in the FMU */
+  osi3::SensorData sensor_data;
+  FieldStatistics generated_statistics;
+  Clock::time_point start = Clock::now();
+  for (const auto& frame : frames)
+  {
+    sensor_data.ParseFromArray(frame.data(), static_cast<int>(frame.size()));
+    FieldCounts counts;
+    CheckSensorDataFields(sensor_data, enabled_checks, counts);
+    generated_statistics.Add(counts, enabled_checks);
+  }
+  const double generated_time = Milliseconds(Clock::now() - start);
+
+  /* Reflection on the dynamic message */
+  FieldStatistics dynamic_statistics;
+  start = Clock::now();
+  for (const auto& frame : frames)
+  {
+    dynamic_checker.Check(frame.data(), static_cast<int>(frame.size()));
+    FieldCounts counts;
+    for (const auto& result : dynamic_checker.GetResults())
+    {
+      FieldCheck check = kCheckMovingObject;
+      if (ParseFieldCheck(result.name, check))
+      {
+        counts.checked[check] += result.checked;
+        counts.missing[check] += result.missing;
+      }
+    }
+    dynamic_statistics.Add(counts, enabled_checks);
+  }
+  const double dynamic_time = Milliseconds(Clock::now() - start);
+
+  std::cout << std::fixed << std::setprecision(2) << frame_count << " frames (" << static_cast<double>(total_bytes) / 1e6 << " MB), " << object_count << " objects and "
+            << detection_count << " detections each" << std::endl;
+  std::cout << "generated: " << generated_time << " ms (" << generated_time / frame_count << " ms per frame)" << std::endl;
+  std::cout << "dynamic:   " << dynamic_time << " ms (" << dynamic_time / frame_count << " ms per frame), " << (generated_time > 0.0 ? dynamic_time / generated_time : 0.0)
+            << " times the generated code" << std::endl;
+  for (int i = 0; i < kFieldCheckCount; i++)
+  {
+    if (generated_statistics.missing[i] > 0 || dynamic_statistics.missing[i] > 0)
+    {
+      std::cout << kFieldCheckNames[i] << ": missing " << generated_statistics.missing[i] << " of " << generated_statistics.checked[i] << " (generated), "
+                << dynamic_statistics.missing[i] << " of " << dynamic_statistics.checked[i] << " (dynamic)" << std::endl;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,230 @@
+//
+// Copyright 2023 BMW AG
+// SPDX-License-Identifier: MPL-2.0
+//
+
+#include "AsyncLogger.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+const char* LogCategoryName(LogCategory category)
+{
+  switch (category)
+  {
+    case kLogFmi:
+      return "FMI";
+    case kLogOsmp:
+      return "OSMP";
+    case kLogOsi:
+      return "OSI";
+  }
+  return "";
+}
+
+AsyncLogger::AsyncLogger(Sink sink, size_t capacity) : sink_(std::move(sink))
+{
+  size_t slot_count = 1;
+  while (slot_count < capacity)
+  {
+    slot_count <<= 1U;
+  }
+  records_.resize(slot_count);
+  mask_ = slot_count - 1;
+  thread_ = std::thread(&AsyncLogger::Run, this);
+}
+
+AsyncLogger::~AsyncLogger()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_.store(true, std::memory_order_release);
+  }
+  wake_.notify_one();
+  thread_.join();
+}
+
+void AsyncLogger::Store(LogRecord& record, const char* value)
+{
+  LogArgument& argument = record.arguments[record.argument_count++];
+  argument.type = LogArgument::kString;
+  argument.size = 0;
+  argument.pointer_value = value;
+  argument.string_offset = static_cast<uint16_t>(record.text_size);
+  if (value == nullptr)
+  {
+    value = "(null)";
+  }
+  const size_t available = LogRecord::kTextSize - record.text_size;
+  if (available == 0)
+  {
+    argument.string_offset = LogRecord::kTextSize - 1;  // points to the terminator of the previous string
+    return;
+  }
+  const size_t length = std::min(strlen(value), available - 1);
+  memcpy(record.text + record.text_size, value, length);
+  record.text[record.text_size + length] = '\0';
+  record.text_size += static_cast<uint32_t>(length + 1);
+}
+
+void AsyncLogger::Flush() const
+{
+  const size_t head = head_.load(std::memory_order_acquire);
+  std::unique_lock<std::mutex> lock(mutex_);
+  drained_.wait(lock, [this, head] { return tail_.load(std::memory_order_acquire) >= head && sleeping_.load(std::memory_order_seq_cst); });
+}
+
+void AsyncLogger::Wake()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);  // the background thread is either before its check of head_ or waiting
+  }
+  wake_.notify_one();
+}
+
+void AsyncLogger::Run()
+{
+  bool idle = true;
+  for (;;)
+  {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail == head_.load(std::memory_order_seq_cst))
+    {
+      if (!idle)
+      {
+        sink_(kLogFmi, 0, nullptr);  // ring ran empty, e.g. to flush files
+        idle = true;
+      }
+      std::unique_lock<std::mutex> lock(mutex_);
+      if (stop_.load(std::memory_order_acquire))
+      {
+        break;
+      }
+      sleeping_.store(true, std::memory_order_seq_cst);
+      drained_.notify_all();
+      wake_.wait(lock, [this, tail] { return head_.load(std::memory_order_seq_cst) != tail || stop_.load(std::memory_order_acquire); });
+      sleeping_.store(false, std::memory_order_relaxed);
+      continue;
+    }
+    const LogRecord& record = records_[tail & mask_];
+    const std::string message = Format(record);
+    sink_(record.category, record.sinks, message.c_str());
+    tail_.store(tail + 1, std::memory_order_release);
+    idle = false;
+  }
+}
+
+/*
+ * Formatting
+ *
+ * Every conversion specification of the format is passed to snprintf on
+ * its own, with the length modifier replaced to match the stored 64 bit
+ * value.  Unsigned conversions of signed arguments are truncated to the
+ * size of the original type, so e.g. %08X of a negative int prints eight
+ * digits like printf would.
+ */
+std::string AsyncLogger::Format(const LogRecord& record)
+{
+  std::string message;
+  uint32_t next_argument = 0;
+  char buffer[256];
+  const char* position = record.format;
+  while (*position != '\0')
+  {
+    if (*position != '%')
+    {
+      const char* literal_end = strchr(position, '%');
+      if (literal_end == nullptr)
+      {
+        literal_end = position + strlen(position);
+      }
+      message.append(position, literal_end);
+      position = literal_end;
+      continue;
+    }
+    if (position[1] == '%')
+    {
+      message += '%';
+      position += 2;
+      continue;
+    }
+
+    /* Flags, width and precision are kept, length modifiers are dropped */
+    const char* spec_begin = position++;
+    std::string spec = "%";
+    while (*position != '\0' && strchr("-+ #0123456789.", *position) != nullptr)
+    {
+      spec += *position++;
+    }
+    while (*position != '\0' && strchr("hlLqjzt", *position) != nullptr)
+    {
+      position++;
+    }
+    const char conversion = *position;
+    if (conversion == '\0' || next_argument >= record.argument_count)
+    {
+      message.append(spec_begin, conversion == '\0' ? position : position + 1);
+      position += conversion == '\0' ? 0 : 1;
+      continue;
+    }
+    position++;
+
+    const LogArgument& argument = record.arguments[next_argument++];
+    const uint64_t size_mask = argument.size >= 8 ? UINT64_MAX : (1ULL << (8U * argument.size)) - 1;
+    int length = 0;
+    switch (conversion)
+    {
+      case 'd':
+      case 'i':
+        spec += "lld";
+        length = snprintf(buffer, sizeof(buffer), spec.c_str(),
+                          argument.type == LogArgument::kDouble ? static_cast<long long>(argument.double_value) : static_cast<long long>(argument.signed_value));
+        break;
+      case 'u':
+      case 'o':
+      case 'x':
+      case 'X':
+        spec += "ll";
+        spec += conversion;
+        length = snprintf(buffer, sizeof(buffer), spec.c_str(), static_cast<unsigned long long>(argument.unsigned_value & size_mask));
+        break;
+      case 'c':
+        spec += 'c';
+        length = snprintf(buffer, sizeof(buffer), spec.c_str(), static_cast<int>(argument.signed_value));
+        break;
+      case 'f':
+      case 'F':
+      case 'e':
+      case 'E':
+      case 'g':
+      case 'G':
+      case 'a':
+      case 'A':
+        spec += conversion;
+        length = snprintf(buffer,
+                          sizeof(buffer),
+                          spec.c_str(),
+                          argument.type == LogArgument::kDouble   ? argument.double_value
+                          : argument.type == LogArgument::kSigned ? static_cast<double>(argument.signed_value)
+                                                                  : static_cast<double>(argument.unsigned_value));
+        break;
+      case 's':
+        spec += 's';
+        length = snprintf(buffer, sizeof(buffer), spec.c_str(), argument.type == LogArgument::kString ? record.text + argument.string_offset : "(?)");
+        break;
+      case 'p':
+        spec += 'p';
+        length = snprintf(buffer, sizeof(buffer), spec.c_str(), argument.pointer_value);
+        break;
+      default:
+        message.append(spec_begin, position);
+        continue;
+    }
+    if (length > 0)
+    {
+      message.append(buffer, std::min(static_cast<size_t>(length), sizeof(buffer) - 1));
+    }
+  }
+  return message;
+}
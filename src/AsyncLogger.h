@@ -0,0 +1,199 @@
+//
+// Copyright 2023 BMW AG
+// SPDX-License-Identifier: MPL-2.0
+//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/*
+ * Asynchronous Logging
+ *
+ * A log call only copies the format pointer and its arguments into a slot
+ * of a single-producer single-consumer ring buffer; no formatting and no
+ * I/O happens on the calling thread.  A background thread per logger takes
+ * the records from the ring, formats them printf-style and hands the text
+ * to the sink, so the sink runs on the background thread and not within
+ * the call that logged the message.  If the ring is full, records are
+ * dropped and counted instead of blocking the caller.
+ *
+ * The background thread sleeps on a condition variable while the ring is
+ * empty.  It announces this in a flag, so a log call only takes the mutex
+ * to wake it when it actually sleeps and otherwise stays lock-free.
+ *
+ * Format strings have to be string literals, since only their address is
+ * stored.  String arguments are copied into the record (truncated to the
+ * text space of the record).
+ *
+ * Categories are filtered at compile time with LOG_CATEGORY_MASK, calls of
+ * categories not in the mask compile to nothing.
+ */
+
+enum LogCategory : uint32_t
+{
+  kLogFmi = 1U,
+  kLogOsmp = 2U,
+  kLogOsi = 4U
+};
+
+#ifndef LOG_CATEGORY_MASK
+#define LOG_CATEGORY_MASK (kLogFmi | kLogOsmp | kLogOsi)
+#endif
+
+const char* LogCategoryName(LogCategory category);
+
+struct LogArgument
+{
+  enum Type : uint8_t
+  {
+    kSigned,
+    kUnsigned,
+    kDouble,
+    kPointer,
+    kString
+  };
+  Type type;
+  uint8_t size;            // size of the original integer type in bytes
+  uint16_t string_offset;  // copy of a string argument in LogRecord::text
+  union
+  {
+    int64_t signed_value;
+    uint64_t unsigned_value;
+    double double_value;
+    const void* pointer_value;  // also kept for strings, so they can be logged with %p
+  };
+};
+
+struct LogRecord
+{
+  static const size_t kMaxArguments = 8;
+  static const size_t kTextSize = 128;
+
+  LogCategory category;
+  uint32_t sinks;  // passed through to the sink unchanged
+  const char* format;
+  uint32_t argument_count;
+  uint32_t text_size;
+  LogArgument arguments[kMaxArguments];
+  char text[kTextSize];
+};
+
+class AsyncLogger
+{
+public:
+  /* Called on the logger thread for every formatted message, and with a null message whenever the ring runs empty */
+  typedef std::function<void(LogCategory category, uint32_t sinks, const char* message)> Sink;
+
+  explicit AsyncLogger(Sink sink, size_t capacity = 512);
+  ~AsyncLogger();
+  AsyncLogger(const AsyncLogger&) = delete;
+  AsyncLogger& operator=(const AsyncLogger&) = delete;
+
+  template <typename... Args>
+  void Log(LogCategory category, uint32_t sinks, const char* format, const Args&... args)
+  {
+    static_assert(sizeof...(Args) <= LogRecord::kMaxArguments, "too many log arguments");
+    const size_t head = head_.load(std::memory_order_relaxed);
+    if (head - tail_.load(std::memory_order_acquire) >= records_.size())
+    {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    LogRecord& record = records_[head & mask_];
+    record.category = category;
+    record.sinks = sinks;
+    record.format = format;
+    record.argument_count = 0;
+    record.text_size = 0;
+    StoreArguments(record, args...);
+
+    /* Sequentially consistent, so either the sleeping thread sees the record or the flag is seen here */
+    head_.store(head + 1, std::memory_order_seq_cst);
+    if (sleeping_.load(std::memory_order_seq_cst))
+    {
+      Wake();
+    }
+  }
+
+  /* Wait until all records logged so far have been passed to the sink */
+  void Flush() const;
+  uint64_t Dropped() const { return dropped_.load(std::memory_order_relaxed); }
+  size_t MemoryUsage() const { return records_.capacity() * sizeof(LogRecord); }
+
+  /* printf-style formatting of a record, conversions without argument are copied literally */
+  static std::string Format(const LogRecord& record);
+
+private:
+  static void StoreArguments(LogRecord& /*record*/) {}
+
+  template <typename T, typename... Rest>
+  static void StoreArguments(LogRecord& record, const T& value, const Rest&... rest)
+  {
+    Store(record, value);
+    StoreArguments(record, rest...);
+  }
+
+  template <typename T>
+  static typename std::enable_if<std::is_integral<T>::value>::type Store(LogRecord& record, const T& value)
+  {
+    LogArgument& argument = record.arguments[record.argument_count++];
+    argument.size = sizeof(T);
+    if (std::is_signed<T>::value)
+    {
+      argument.type = LogArgument::kSigned;
+      argument.signed_value = static_cast<int64_t>(value);
+    }
+    else
+    {
+      argument.type = LogArgument::kUnsigned;
+      argument.unsigned_value = static_cast<uint64_t>(value);
+    }
+  }
+
+  template <typename T>
+  static typename std::enable_if<std::is_floating_point<T>::value>::type Store(LogRecord& record, const T& value)
+  {
+    LogArgument& argument = record.arguments[record.argument_count++];
+    argument.type = LogArgument::kDouble;
+    argument.size = sizeof(double);
+    argument.double_value = static_cast<double>(value);
+  }
+
+  template <typename T>
+  static void Store(LogRecord& record, const T* value)
+  {
+    LogArgument& argument = record.arguments[record.argument_count++];
+    argument.type = LogArgument::kPointer;
+    argument.size = sizeof(value);
+    argument.pointer_value = value;
+  }
+
+  /* Strings are copied, the caller's buffer may be gone when the record is formatted */
+  static void Store(LogRecord& record, const char* value);
+
+  void Wake();
+  void Run();
+
+  std::vector<LogRecord> records_;
+  size_t mask_;
+  std::atomic<size_t> head_{0};
+  std::atomic<size_t> tail_{0};
+  std::atomic<uint64_t> dropped_{0};
+  std::atomic<bool> stop_{false};
+  std::atomic<bool> sleeping_{false};  // the background thread waits for records on wake_
+  mutable std::mutex mutex_;
+  std::condition_variable wake_;
+  mutable std::condition_variable drained_;  // the ring ran empty and the sink was told
+  Sink sink_;
+  std::thread thread_;
+};
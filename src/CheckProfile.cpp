@@ -0,0 +1,311 @@
+//
+// Copyright 2023 BMW AG
+// SPDX-License-Identifier: MPL-2.0
+//
+
+#include "CheckProfile.h"
+
+#include <cstddef>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+
+#include <sys/stat.h>
+
+#include "ObjectRecall.h"
+#include "TemporalConsistency.h"
+#include "osi_sensordata.pb.h"
+
+namespace
+{
+
+uint64_t HashBytes(const char* data, size_t size)
+{
+  uint64_t hash = 0xcbf29ce484222325ULL;  // 64 bit FNV-1a
+  for (size_t i = 0; i < size; i++)
+  {
+    hash ^= static_cast<unsigned char>(data[i]);
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+/* Size and modification time of a file, equal stamps are taken as unchanged content */
+struct FileStamp
+{
+  uint64_t size = 0;
+  time_t modified = 0;
+
+  bool operator==(const FileStamp& other) const { return size == other.size && modified == other.modified; }
+};
+
+bool GetFileStamp(const std::string& path, FileStamp& stamp)
+{
+  struct stat status;
+  if (stat(path.c_str(), &status) != 0)
+  {
+    return false;
+  }
+  stamp.size = static_cast<uint64_t>(status.st_size);
+  stamp.modified = status.st_mtime;
+  return true;
+}
+
+void AppendUint32(std::string& data, uint32_t value)
+{
+  for (int shift = 0; shift < 32; shift += 8)
+  {
+    data.push_back(static_cast<char>((value >> shift) & 0xffU));
+  }
+}
+
+uint32_t ReadUint32(const char* data)
+{
+  const auto* bytes = reinterpret_cast<const unsigned char*>(data);
+  return static_cast<uint32_t>(bytes[0]) | (static_cast<uint32_t>(bytes[1]) << 8) | (static_cast<uint32_t>(bytes[2]) << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+}
+
+bool ReadFile(const std::string& path, std::string& content)
+{
+  std::ifstream file(path, std::ios::in | std::ios::binary);
+  if (!file.is_open())
+  {
+    return false;
+  }
+  char buffer[4096];
+  while (file.read(buffer, sizeof(buffer)) || file.gcount() > 0)
+  {
+    content.append(buffer, static_cast<size_t>(file.gcount()));
+  }
+  return !file.bad();
+}
+
+bool IsSensorDataFieldPath(const std::string& path)
+{
+  const google::protobuf::Descriptor* type = osi3::SensorData::descriptor();
+  std::istringstream components(path);
+  std::string component;
+  bool resolved = false;
+  while (std::getline(components, component, '.'))
+  {
+    const google::protobuf::FieldDescriptor* field = type != nullptr ? type->FindFieldByName(component) : nullptr;
+    if (field == nullptr)
+    {
+      return false;
+    }
+    type = field->message_type();
+    resolved = true;
+  }
+  return resolved;
+}
+
+}  // namespace
+
+/*
+ * Check Profile
+ */
+
+const char CheckProfile::kMagic[8] = {'O', 'S', 'I', 'C', 'H', 'K', 'P', '\0'};
+
+bool CheckProfile::Entry::operator==(const char* name) const
+{
+  return strlen(name) == size && memcmp(data, name, size) == 0;
+}
+
+std::shared_ptr<const CheckProfile> CheckProfile::Load(const std::string& path, std::string& error)
+{
+  struct CachedFile
+  {
+    FileStamp stamp;
+    std::weak_ptr<const CheckProfile> profile;
+  };
+  static std::mutex cache_mutex;
+  static std::multimap<uint64_t, std::weak_ptr<const CheckProfile>> cache;
+  static std::map<std::string, CachedFile> cached_files;
+
+  FileStamp stamp;
+  const bool has_stamp = GetFileStamp(path, stamp);
+  if (has_stamp)
+  {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    const auto cached_file = cached_files.find(path);
+    if (cached_file != cached_files.end())
+    {
+      std::shared_ptr<const CheckProfile> profile = cached_file->second.profile.lock();
+      if (profile && cached_file->second.stamp == stamp)
+      {
+        return profile;
+      }
+      cached_files.erase(cached_file);
+    }
+  }
+
+  /* The file is copied, so changing it on disk cannot affect loaded profiles */
+  std::string content;
+  if (!ReadFile(path, content))
+  {
+    error = "cannot open check file " + path;
+    return nullptr;
+  }
+
+  const uint64_t hash = HashBytes(content.data(), content.size());
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  for (auto cached = cache.begin(); cached != cache.end();)
+  {
+    std::shared_ptr<const CheckProfile> profile = cached->second.lock();
+    if (!profile)
+    {
+      cached = cache.erase(cached);  // all instances using the profile are gone
+      continue;
+    }
+    if (cached->first == hash && profile->content_ == content)  // equal hashes of different content are told apart by the bytes
+    {
+      if (has_stamp)
+      {
+        cached_files[path] = CachedFile{stamp, profile};
+      }
+      return profile;
+    }
+    ++cached;
+  }
+
+  std::shared_ptr<CheckProfile> new_profile(new CheckProfile());
+  new_profile->content_ = std::move(content);
+  new_profile->hash_ = hash;
+  const std::string& file = new_profile->content_;
+  if (file.size() >= sizeof(ProfileHeader) && memcmp(file.data(), kMagic, sizeof(kMagic)) == 0)
+  {
+    if (!new_profile->ParseBinary(error))
+    {
+      return nullptr;
+    }
+  }
+  else
+  {
+    new_profile->ParseText();
+  }
+
+  for (const auto& entry : new_profile->entries_)
+  {
+    FieldCheck check = kCheckMovingObject;
+    if (ParseFieldCheck(entry.ToString(), check))
+    {
+      new_profile->enabled_checks_ |= FieldCheckBit(check);
+    }
+  }
+  cache.emplace(hash, new_profile);
+  if (has_stamp)
+  {
+    cached_files[path] = CachedFile{stamp, new_profile};
+  }
+  return new_profile;
+}
+
+void CheckProfile::ParseText()
+{
+  const char* position = content_.data();
+  const char* const end = position + content_.size();
+  while (position < end)
+  {
+    const char* line_end = static_cast<const char*>(memchr(position, '\n', static_cast<size_t>(end - position)));
+    if (line_end == nullptr)
+    {
+      line_end = end;
+    }
+    size_t size = static_cast<size_t>(line_end - position);
+    if (size > 0 && position[size - 1] == '\r')
+    {
+      size--;
+    }
+    if (size > 0)
+    {
+      entries_.push_back({position, size});
+    }
+    position = line_end + 1;
+  }
+}
+
+bool CheckProfile::ParseBinary(std::string& error)
+{
+  const char* data = content_.data();
+  ProfileHeader header{};
+  memcpy(header.magic, data + offsetof(ProfileHeader, magic), sizeof(header.magic));
+  header.format_version = ReadUint32(data + offsetof(ProfileHeader, format_version));
+  header.entry_count = ReadUint32(data + offsetof(ProfileHeader, entry_count));
+  header.string_table_size = ReadUint32(data + offsetof(ProfileHeader, string_table_size));
+  header.reserved = ReadUint32(data + offsetof(ProfileHeader, reserved));
+  memcpy(header.osi_version, data + offsetof(ProfileHeader, osi_version), sizeof(header.osi_version));
+  if (header.format_version != kFormatVersion)
+  {
+    error = "unsupported check profile format version " + std::to_string(header.format_version);
+    return false;
+  }
+  const size_t entries_size = static_cast<size_t>(header.entry_count) * sizeof(ProfileEntry);
+  if (sizeof(header) + entries_size + header.string_table_size > content_.size())
+  {
+    error = "truncated check profile";
+    return false;
+  }
+
+  const char* entry_table = data + sizeof(header);
+  const char* string_table = entry_table + entries_size;
+  entries_.reserve(header.entry_count);
+  for (uint32_t i = 0; i < header.entry_count; i++)
+  {
+    const char* entry_data = entry_table + i * sizeof(ProfileEntry);
+    const ProfileEntry entry{ReadUint32(entry_data + offsetof(ProfileEntry, offset)), ReadUint32(entry_data + offsetof(ProfileEntry, size))};
+    if (static_cast<uint64_t>(entry.offset) + entry.size > header.string_table_size)
+    {
+      error = "invalid entry in check profile";
+      return false;
+    }
+    entries_.push_back({string_table + entry.offset, entry.size});
+  }
+  compiled_ = true;
+  osi_version_.assign(header.osi_version, strnlen(header.osi_version, sizeof(header.osi_version)));
+  return true;
+}
+
+std::string CheckProfile::Compile(const std::vector<std::string>& entries, const std::string& osi_version)
+{
+  std::string entry_table;
+  std::string string_table;
+  for (const auto& entry : entries)
+  {
+    AppendUint32(entry_table, static_cast<uint32_t>(string_table.size()));
+    AppendUint32(entry_table, static_cast<uint32_t>(entry.size()));
+    string_table += entry;
+  }
+
+  char osi_version_field[sizeof(ProfileHeader::osi_version)] = {};
+  strncpy(osi_version_field, osi_version.c_str(), sizeof(osi_version_field) - 1);
+  std::string profile(kMagic, sizeof(kMagic));
+  AppendUint32(profile, kFormatVersion);
+  AppendUint32(profile, static_cast<uint32_t>(entries.size()));
+  AppendUint32(profile, static_cast<uint32_t>(string_table.size()));
+  AppendUint32(profile, 0);
+  profile.append(osi_version_field, sizeof(osi_version_field));
+  return profile + entry_table + string_table;
+}
+
+bool CheckProfile::IsValidEntry(const std::string& entry)
+{
+  FieldCheck check = kCheckMovingObject;
+  return ParseFieldCheck(entry, check) || entry == kCheckTemporalTimestamp || entry == kCheckTemporalTrackingId || entry == kCheckObjectRecall ||
+         IsSensorDataFieldPath(entry);
+}
+
+bool CheckProfile::Contains(const char* name) const
+{
+  for (const auto& entry : entries_)
+  {
+    if (entry == name)
+    {
+      return true;
+    }
+  }
+  return false;
+}
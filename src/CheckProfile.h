@@ -0,0 +1,96 @@
+//
+// Copyright 2023 BMW AG
+// SPDX-License-Identifier: MPL-2.0
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "FieldChecks.h"
+
+/*
+ * Check Profiles
+ *
+ * A check profile is the list of entries of a check file.  It is either
+ * read from the plain text check file (one entry per line) or from a
+ * compiled binary profile, see CompileCheckProfile.cpp.  The file is read
+ * into memory once and the entries refer directly to its bytes.  Profiles
+ * are cached per process by their file content, so all instances using the
+ * same check file share one read-only copy, which is freed with the last
+ * instance using it.  A file whose path, size and modification time match
+ * a cached profile is not read again.
+ *
+ * Binary profile layout (little-endian, independent of the host):
+ *
+ *   ProfileHeader
+ *   ProfileEntry[entry_count]   offset and size into the string table
+ *   char[string_table_size]     entry names, not terminated
+ */
+
+#ifndef OSI_VERSION
+#define OSI_VERSION "unknown"
+#endif
+
+struct ProfileHeader
+{
+  char magic[8];
+  uint32_t format_version;
+  uint32_t entry_count;
+  uint32_t string_table_size;
+  uint32_t reserved;
+  char osi_version[16];
+};
+static_assert(sizeof(ProfileHeader) == 40, "ProfileHeader must not contain padding");
+
+struct ProfileEntry
+{
+  uint32_t offset;
+  uint32_t size;
+};
+static_assert(sizeof(ProfileEntry) == 8, "ProfileEntry must not contain padding");
+
+class CheckProfile
+{
+public:
+  static const char kMagic[8];
+  static const uint32_t kFormatVersion = 1;
+
+  struct Entry
+  {
+    const char* data;
+    size_t size;
+    std::string ToString() const { return std::string(data, size); }
+    bool operator==(const char* name) const;
+  };
+
+  /* Load a text check file or binary profile, returns the shared profile if the same content was loaded before */
+  static std::shared_ptr<const CheckProfile> Load(const std::string& path, std::string& error);
+  /* Serialize entries into a binary profile */
+  static std::string Compile(const std::vector<std::string>& entries, const std::string& osi_version);
+  /* Entries the checker understands: field checks, temporal checks and field paths of osi3::SensorData */
+  static bool IsValidEntry(const std::string& entry);
+
+  const std::vector<Entry>& Entries() const { return entries_; }
+  bool Contains(const char* name) const;
+  FieldCheckMask EnabledChecks() const { return enabled_checks_; }
+  bool IsCompiled() const { return compiled_; }
+  const std::string& OsiVersion() const { return osi_version_; }
+  uint64_t Hash() const { return hash_; }
+
+private:
+  CheckProfile() = default;
+  bool ParseBinary(std::string& error);
+  void ParseText();
+
+  std::string content_;
+  std::vector<Entry> entries_;
+  FieldCheckMask enabled_checks_ = 0;
+  bool compiled_ = false;
+  std::string osi_version_;
+  uint64_t hash_ = 0;
+};
@@ -0,0 +1,64 @@
+//
+// Copyright 2023 BMW AG
+// SPDX-License-Identifier: MPL-2.0
+//
+
+/*
+ * Compiles an OSI check file into a binary check profile
+ *
+ * Every entry is validated against the check table and the descriptors of
+ * the OSI version this tool is linked with.  The resulting profile can be
+ * passed as check_file to the OSIFieldChecker FMU instead of the text file.
+ *
+ * Usage: CompileCheckProfile <osi_check.txt> <profile.osicp>
+ */
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "CheckProfile.h"
+
+int main(int argc, char** argv)
+{
+  if (argc != 3)
+  {
+    std::cerr << "Usage: " << argv[0] << " <osi_check.txt> <profile.osicp>" << std::endl;
+    return 2;
+  }
+
+  std::string error;
+  std::shared_ptr<const CheckProfile> text_profile = CheckProfile::Load(argv[1], error);
+  if (!text_profile)
+  {
+    std::cerr << error << std::endl;
+    return 1;
+  }
+
+  std::vector<std::string> entries;
+  bool valid = true;
+  for (const auto& entry : text_profile->Entries())
+  {
+    entries.push_back(entry.ToString());
+    if (!CheckProfile::IsValidEntry(entries.back()))
+    {
+      std::cerr << argv[1] << ": unknown entry " << entries.back() << std::endl;
+      valid = false;
+    }
+  }
+  if (!valid)
+  {
+    return 1;
+  }
+
+  std::ofstream profile_file(argv[2], std::ios::out | std::ios::binary | std::ios::trunc);
+  profile_file << CheckProfile::Compile(entries, OSI_VERSION);
+  if (!profile_file.good())
+  {
+    std::cerr << "cannot write " << argv[2] << std::endl;
+    return 1;
+  }
+  std::cout << "Compiled " << entries.size() << " entries for OSI " << OSI_VERSION << " into " << argv[2] << std::endl;
+  return 0;
+}
@@ -0,0 +1,212 @@
+//
+// Copyright 2023 BMW AG
+// SPDX-License-Identifier: MPL-2.0
+//
+
+#include "DynamicFieldChecker.h"
+
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+
+#include <google/protobuf/descriptor.pb.h>
+
+using google::protobuf::Descriptor;
+using google::protobuf::FieldDescriptor;
+using google::protobuf::Message;
+using google::protobuf::Reflection;
+
+/*
+ * Dynamic Schema
+ */
+
+std::shared_ptr<const DynamicSchema> DynamicSchema::Load(const std::string& path, std::string& error)
+{
+  static std::mutex cache_mutex;
+  static std::map<std::string, std::weak_ptr<const DynamicSchema>> cache;
+
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  std::shared_ptr<const DynamicSchema> cached = cache[path].lock();
+  if (cached)
+  {
+    return cached;
+  }
+
+  std::ifstream descriptor_set_file(path, std::ios::in | std::ios::binary);
+  google::protobuf::FileDescriptorSet descriptor_set;
+  if (!descriptor_set_file.is_open() || !descriptor_set.ParseFromIstream(&descriptor_set_file))
+  {
+    error = "cannot read descriptor set " + path;
+    return nullptr;
+  }
+
+  std::shared_ptr<DynamicSchema> schema(new DynamicSchema());
+  schema->database_.reset(new google::protobuf::SimpleDescriptorDatabase());
+  for (const auto& file : descriptor_set.file())
+  {
+    if (!schema->database_->Add(file))
+    {
+      error = "invalid file " + file.name() + " in descriptor set " + path;
+      return nullptr;
+    }
+  }
+  schema->pool_.reset(new google::protobuf::DescriptorPool(schema->database_.get()));
+  schema->factory_.reset(new google::protobuf::DynamicMessageFactory(schema->pool_.get()));
+  cache[path] = schema;
+  return schema;
+}
+
+/*
+ * Dynamic Field Checker
+ */
+
+bool DynamicFieldChecker::Load(const std::string& descriptor_set_path, const std::string& message_type, std::string& error)
+{
+  Unload();
+  std::shared_ptr<const DynamicSchema> schema = DynamicSchema::Load(descriptor_set_path, error);
+  if (!schema)
+  {
+    return false;
+  }
+  const Descriptor* type = schema->FindMessageType(message_type);
+  if (type == nullptr)
+  {
+    error = "message type " + message_type + " not found in descriptor set " + descriptor_set_path;
+    return false;
+  }
+  schema_ = schema;
+  type_ = type;
+  message_.reset(schema_->GetPrototype(type_)->New());
+  return true;
+}
+
+void DynamicFieldChecker::Unload()
+{
+  message_.reset();
+  type_ = nullptr;
+  schema_.reset();
+  paths_.clear();
+  results_.clear();
+}
+
+std::vector<std::string> DynamicFieldChecker::SetFieldPaths(const std::set<std::string>& field_paths)
+{
+  std::vector<std::string> unresolved;
+  paths_.clear();
+  results_.clear();
+  for (const auto& field_path : field_paths)
+  {
+    FieldPath path;
+    const Descriptor* type = type_;
+    std::istringstream components(field_path);
+    std::string component;
+    while (std::getline(components, component, '.'))
+    {
+      const FieldDescriptor* field = type != nullptr ? type->FindFieldByName(component) : nullptr;
+      if (field == nullptr)
+      {
+        path.fields.clear();
+        break;
+      }
+      path.fields.push_back(field);
+      type = field->message_type();
+    }
+    if (path.fields.empty())
+    {
+      unresolved.push_back(field_path);
+      continue;
+    }
+    paths_.push_back(path);
+    results_.push_back(FieldResult());
+    results_.back().name = field_path;
+  }
+  return unresolved;
+}
+
+bool DynamicFieldChecker::Check(const void* data, int size)
+{
+  if (!message_->ParseFromArray(data, size))
+  {
+    return false;
+  }
+  for (size_t i = 0; i < paths_.size(); i++)
+  {
+    results_[i].checked = 0;
+    results_[i].missing = 0;
+    CheckPath(*message_, paths_[i], 0, results_[i]);
+  }
+  return true;
+}
+
+size_t DynamicFieldChecker::MessageMemoryUsage() const
+{
+  return message_ ? message_->SpaceUsedLong() : 0;
+}
+
+void DynamicFieldChecker::ReleaseMessage()
+{
+  if (IsLoaded())
+  {
+    message_.reset(schema_->GetPrototype(type_)->New());
+  }
+}
+
+int DynamicFieldChecker::RepeatedFieldSize(const std::string& name) const
+{
+  const FieldDescriptor* field = type_ != nullptr ? type_->FindFieldByName(name) : nullptr;
+  if (field == nullptr || !field->is_repeated())
+  {
+    return 0;
+  }
+  return message_->GetReflection()->FieldSize(*message_, field);
+}
+
+bool DynamicFieldChecker::IsPresent(const Message& message, const FieldDescriptor* field)
+{
+  const Reflection* reflection = message.GetReflection();
+  if (field->is_repeated())
+  {
+    return reflection->FieldSize(message, field) > 0;
+  }
+  if (!reflection->HasField(message, field))
+  {
+    return false;
+  }
+  switch (field->cpp_type())
+  {
+    case FieldDescriptor::CPPTYPE_DOUBLE:
+      return std::isfinite(reflection->GetDouble(message, field));
+    case FieldDescriptor::CPPTYPE_FLOAT:
+      return std::isfinite(reflection->GetFloat(message, field));
+    default:
+      return true;
+  }
+}
+
+void DynamicFieldChecker::CheckPath(const Message& message, const FieldPath& path, size_t depth, FieldResult& result) const
+{
+  const FieldDescriptor* field = path.fields[depth];
+  if (depth + 1 == path.fields.size())
+  {
+    result.checked++;
+    result.missing += IsPresent(message, field) ? 0 : 1;
+    return;
+  }
+
+  /* Descend into present intermediate messages only, like the generated checks do */
+  const Reflection* reflection = message.GetReflection();
+  if (field->is_repeated())
+  {
+    const int size = reflection->FieldSize(message, field);
+    for (int i = 0; i < size; i++)
+    {
+      CheckPath(reflection->GetRepeatedMessage(message, field, i), path, depth + 1, result);
+    }
+  }
+  else if (reflection->HasField(message, field))
+  {
+    CheckPath(reflection->GetMessage(message, field), path, depth + 1, result);
+  }
+}
@@ -0,0 +1,90 @@
+//
+// Copyright 2023 BMW AG
+// SPDX-License-Identifier: MPL-2.0
+//
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/descriptor_database.h>
+#include <google/protobuf/dynamic_message.h>
+#include <google/protobuf/message.h>
+
+/*
+ * Field checks on messages described by a FileDescriptorSet loaded at runtime
+ *
+ * Instead of the generated OSI classes linked into the FMU, the input is
+ * parsed into a DynamicMessage whose type is taken from a serialized
+ * FileDescriptorSet (e.g. produced with protoc --include_imports
+ * --descriptor_set_out).  One FMU binary can thereby check data of any OSI
+ * version.  Descriptor pool and DynamicMessageFactory of a descriptor set
+ * are created once per process and shared by all instances.
+ *
+ * Every check file entry that resolves to a field path of the message type
+ * is checked by reflection: repeated message fields on the way are checked
+ * for every element, repeated leaf fields have to be non-empty, all other
+ * leaf fields have to be set and floating point values finite.  Entries
+ * that do not resolve are ignored.
+ */
+
+class DynamicSchema
+{
+public:
+  /* Load a descriptor set, returns the cached schema if the file was loaded before */
+  static std::shared_ptr<const DynamicSchema> Load(const std::string& path, std::string& error);
+
+  const google::protobuf::Descriptor* FindMessageType(const std::string& name) const { return pool_->FindMessageTypeByName(name); }
+  const google::protobuf::Message* GetPrototype(const google::protobuf::Descriptor* type) const { return factory_->GetPrototype(type); }
+
+private:
+  std::unique_ptr<google::protobuf::SimpleDescriptorDatabase> database_;
+  std::unique_ptr<google::protobuf::DescriptorPool> pool_;
+  std::unique_ptr<google::protobuf::DynamicMessageFactory> factory_;
+};
+
+class DynamicFieldChecker
+{
+public:
+  struct FieldResult
+  {
+    std::string name;
+    uint64_t checked = 0;
+    uint64_t missing = 0;
+  };
+
+  /* Replaces the loaded message type, on failure the checker is left unloaded */
+  bool Load(const std::string& descriptor_set_path, const std::string& message_type, std::string& error);
+  void Unload();
+  bool IsLoaded() const { return schema_ && message_; }
+  /* Resolve check file entries against the message type, returns the entries that could not be resolved */
+  std::vector<std::string> SetFieldPaths(const std::set<std::string>& field_paths);
+  /* Parse and check one serialized message, the results of the frame are available from GetResults() */
+  bool Check(const void* data, int size);
+  const std::vector<FieldResult>& GetResults() const { return results_; }
+  int RepeatedFieldSize(const std::string& name) const;
+  /* Memory held by the reused message, and release of it until the next Check() */
+  size_t MessageMemoryUsage() const;
+  void ReleaseMessage();
+
+private:
+  struct FieldPath
+  {
+    std::vector<const google::protobuf::FieldDescriptor*> fields;
+  };
+
+  void CheckPath(const google::protobuf::Message& message, const FieldPath& path, size_t depth, FieldResult& result) const;
+  static bool IsPresent(const google::protobuf::Message& message, const google::protobuf::FieldDescriptor* field);
+
+  /* message_ is created by the factory of schema_ and has to be destroyed first */
+  std::shared_ptr<const DynamicSchema> schema_;
+  const google::protobuf::Descriptor* type_ = nullptr;
+  std::unique_ptr<google::protobuf::Message> message_;
+  std::vector<FieldPath> paths_;
+  std::vector<FieldResult> results_;
+};
@@ -0,0 +1,281 @@
+//
+// Copyright 2023 BMW AG
+// SPDX-License-Identifier: MPL-2.0
+//
+
+#include "FieldChecks.h"
+
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+const char* const kFieldCheckNames[kFieldCheckCount] = {"moving_object",
+                                                        "moving_object.base",
+                                                        "moving_object.base.dimension",
+                                                        "moving_object.base.position",
+                                                        "moving_object.base.orientation",
+                                                        "moving_object.base.velocity",
+                                                        "moving_object.base.acceleration",
+                                                        "moving_object.base.orientation_rate",
+                                                        "moving_object.base.orientation_acceleration",
+                                                        "moving_object.base.base_polygon",
+                                                        "feature_data.lidar_sensor.detection",
+                                                        "feature_data.lidar_sensor.detection.position",
+                                                        "feature_data.lidar_sensor.detection.intensity",
+                                                        "feature_data.lidar_sensor.detection.existence_probability",
+                                                        "feature_data.radar_sensor.detection",
+                                                        "feature_data.radar_sensor.detection.position",
+                                                        "feature_data.radar_sensor.detection.rcs",
+                                                        "feature_data.radar_sensor.detection.existence_probability"};
+
+bool ParseFieldCheck(const std::string& name, FieldCheck& check)
+{
+  for (int i = 0; i < kFieldCheckCount; i++)
+  {
+    if (name == kFieldCheckNames[i])
+    {
+      check = static_cast<FieldCheck>(i);
+      return true;
+    }
+  }
+  return false;
+}
+
+void FieldStatistics::Add(const FieldCounts& counts, FieldCheckMask enabled_checks)
+{
+  for (int i = 0; i < kFieldCheckCount; i++)
+  {
+    if ((enabled_checks & FieldCheckBit(static_cast<FieldCheck>(i))) == 0)
+    {
+      continue;
+    }
+    checked[i] += counts.checked[i];
+    missing[i] += counts.missing[i];
+    frames_missing[i] += static_cast<uint64_t>(counts.missing[i] > 0);
+  }
+}
+
+double FieldStatistics::FillRate(FieldCheck check) const
+{
+  if (checked[check] == 0)
+  {
+    return 1.0;
+  }
+  return 1.0 - static_cast<double>(missing[check]) / static_cast<double>(checked[check]);
+}
+
+const char* FieldCheckUnit(FieldCheck check)
+{
+  if (check == kCheckMovingObject || check == kCheckLidarDetection || check == kCheckRadarDetection)
+  {
+    return "frames";
+  }
+  return check < kCheckLidarDetection ? "moving objects" : "detections";
+}
+
+std::string DescribeFieldStatistics(const FieldStatistics& statistics, FieldCheck check)
+{
+  std::ostringstream description;
+  description << "missing in " << statistics.missing[check] << " of " << statistics.checked[check] << " " << FieldCheckUnit(check) << " (fill rate " << std::fixed
+              << std::setprecision(2) << 100.0 * statistics.FillRate(check) << " %)";
+  if (check != kCheckMovingObject && check != kCheckLidarDetection && check != kCheckRadarDetection)
+  {
+    description << " in " << statistics.frames_missing[check] << " frames";
+  }
+  return description.str();
+}
+
+FieldReport ReportFieldStatistics(const FieldStatistics& statistics, double min_fill_rate)
+{
+  FieldReport report;
+  for (int i = 0; i < kFieldCheckCount; i++)
+  {
+    const auto check = static_cast<FieldCheck>(i);
+    if (statistics.missing[i] == 0)
+    {
+      continue;
+    }
+    const bool below_min_fill_rate = statistics.FillRate(check) < min_fill_rate;
+    report.lines.push_back(std::string(below_min_fill_rate ? "::error title=MissingField::" : "::warning title=FillRate::") + kFieldCheckNames[i] + " " +
+                           DescribeFieldStatistics(statistics, check));
+    report.failed = report.failed || below_min_fill_rate;
+  }
+  return report;
+}
+
+FieldCheckMask CheckMovingObject(const osi3::DetectedMovingObject& moving_object, FieldCheckMask enabled_checks, FieldCounts& counts)
+{
+  counts.checked[kCheckMovingObjectBase]++;
+  if (!moving_object.has_base())
+  {
+    counts.missing[kCheckMovingObjectBase]++;
+    return enabled_checks & FieldCheckBit(kCheckMovingObjectBase);
+  }
+
+  const osi3::BaseMoving& base = moving_object.base();
+  FieldCheckMask missing = 0;
+  missing |= base.has_dimension() ? 0 : FieldCheckBit(kCheckMovingObjectBaseDimension);
+  missing |= base.has_position() ? 0 : FieldCheckBit(kCheckMovingObjectBasePosition);
+  missing |= base.has_orientation() ? 0 : FieldCheckBit(kCheckMovingObjectBaseOrientation);
+  missing |= base.has_velocity() ? 0 : FieldCheckBit(kCheckMovingObjectBaseVelocity);
+  missing |= base.has_acceleration() ? 0 : FieldCheckBit(kCheckMovingObjectBaseAcceleration);
+  missing |= base.has_orientation_rate() ? 0 : FieldCheckBit(kCheckMovingObjectBaseOrientationRate);
+  missing |= base.has_orientation_acceleration() ? 0 : FieldCheckBit(kCheckMovingObjectBaseOrientationAcceleration);
+  missing |= base.base_polygon().empty() ? FieldCheckBit(kCheckMovingObjectBaseBasePolygon) : 0;
+  for (int i = kCheckMovingObjectBaseDimension; i <= kCheckMovingObjectBaseBasePolygon; i++)
+  {
+    counts.checked[i]++;
+    counts.missing[i] += (missing >> static_cast<unsigned>(i)) & 1U;
+  }
+  return missing & enabled_checks;
+}
+
+namespace
+{
+
+inline bool IsValidPosition(const osi3::Spherical3d& position)
+{
+  return std::isfinite(position.distance()) & std::isfinite(position.azimuth()) & std::isfinite(position.elevation());
+}
+
+inline FieldCheckMask MissingIf(uint64_t missing_count, FieldCheck check)
+{
+  return missing_count > 0 ? FieldCheckBit(check) : 0;
+}
+
+}  // namespace
+
+/*
+ * The detection loops evaluate every field of a detection with the non
+ * short-circuiting & and accumulate the results arithmetically, so the
+ * loop bodies contain no data dependent branches.  An unset position reads
+ * the finite default instance, so it is safe to validate it unconditionally.
+ * The detections are separate messages on the heap, so the loops are bound
+ * by loading them rather than by the checks themselves.
+ */
+FieldCheckMask CheckLidarDetections(const osi3::LidarDetectionData& lidar_sensor, int begin, int end, FieldCheckMask enabled_checks, FieldCounts& counts)
+{
+  uint64_t missing_position = 0;
+  uint64_t missing_intensity = 0;
+  uint64_t missing_existence_probability = 0;
+  const auto first = lidar_sensor.detection().begin() + begin;
+  const auto last = lidar_sensor.detection().begin() + end;
+  for (auto detection = first; detection != last; ++detection)
+  {
+    missing_position += static_cast<uint64_t>(!(detection->has_position() & IsValidPosition(detection->position())));
+    missing_intensity += static_cast<uint64_t>(!(detection->has_intensity() & std::isfinite(detection->intensity())));
+    missing_existence_probability += static_cast<uint64_t>(!(detection->has_existence_probability() & std::isfinite(detection->existence_probability())));
+  }
+  const auto detections = static_cast<uint64_t>(end - begin);
+  counts.checked[kCheckLidarDetectionPosition] += detections;
+  counts.checked[kCheckLidarDetectionIntensity] += detections;
+  counts.checked[kCheckLidarDetectionExistenceProbability] += detections;
+  counts.missing[kCheckLidarDetectionPosition] += missing_position;
+  counts.missing[kCheckLidarDetectionIntensity] += missing_intensity;
+  counts.missing[kCheckLidarDetectionExistenceProbability] += missing_existence_probability;
+  const FieldCheckMask missing = MissingIf(missing_position, kCheckLidarDetectionPosition) | MissingIf(missing_intensity, kCheckLidarDetectionIntensity) |
+                                 MissingIf(missing_existence_probability, kCheckLidarDetectionExistenceProbability);
+  return missing & enabled_checks;
+}
+
+FieldCheckMask CheckRadarDetections(const osi3::RadarDetectionData& radar_sensor, int begin, int end, FieldCheckMask enabled_checks, FieldCounts& counts)
+{
+  uint64_t missing_position = 0;
+  uint64_t missing_rcs = 0;
+  uint64_t missing_existence_probability = 0;
+  const auto first = radar_sensor.detection().begin() + begin;
+  const auto last = radar_sensor.detection().begin() + end;
+  for (auto detection = first; detection != last; ++detection)
+  {
+    missing_position += static_cast<uint64_t>(!(detection->has_position() & IsValidPosition(detection->position())));
+    missing_rcs += static_cast<uint64_t>(!(detection->has_rcs() & std::isfinite(detection->rcs())));
+    missing_existence_probability += static_cast<uint64_t>(!(detection->has_existence_probability() & std::isfinite(detection->existence_probability())));
+  }
+  const auto detections = static_cast<uint64_t>(end - begin);
+  counts.checked[kCheckRadarDetectionPosition] += detections;
+  counts.checked[kCheckRadarDetectionRcs] += detections;
+  counts.checked[kCheckRadarDetectionExistenceProbability] += detections;
+  counts.missing[kCheckRadarDetectionPosition] += missing_position;
+  counts.missing[kCheckRadarDetectionRcs] += missing_rcs;
+  counts.missing[kCheckRadarDetectionExistenceProbability] += missing_existence_probability;
+  const FieldCheckMask missing = MissingIf(missing_position, kCheckRadarDetectionPosition) | MissingIf(missing_rcs, kCheckRadarDetectionRcs) |
+                                 MissingIf(missing_existence_probability, kCheckRadarDetectionExistenceProbability);
+  return missing & enabled_checks;
+}
+
+FieldCheckMask CheckDetectionArrays(const osi3::FeatureData& feature_data, FieldCheckMask enabled_checks, FieldCounts& counts)
+{
+  FieldCheckMask missing = 0;
+
+  if ((enabled_checks & kLidarChecks) != 0)
+  {
+    bool empty = feature_data.lidar_sensor().empty();
+    for (const auto& lidar_sensor : feature_data.lidar_sensor())
+    {
+      empty = empty || lidar_sensor.detection().empty();
+    }
+    counts.checked[kCheckLidarDetection]++;
+    counts.missing[kCheckLidarDetection] += static_cast<uint64_t>(empty);
+    missing |= empty ? FieldCheckBit(kCheckLidarDetection) : 0;
+  }
+
+  if ((enabled_checks & kRadarChecks) != 0)
+  {
+    bool empty = feature_data.radar_sensor().empty();
+    for (const auto& radar_sensor : feature_data.radar_sensor())
+    {
+      empty = empty || radar_sensor.detection().empty();
+    }
+    counts.checked[kCheckRadarDetection]++;
+    counts.missing[kCheckRadarDetection] += static_cast<uint64_t>(empty);
+    missing |= empty ? FieldCheckBit(kCheckRadarDetection) : 0;
+  }
+
+  return missing & enabled_checks;
+}
+
+FieldCheckMask CheckFrameArrays(const osi3::SensorData& sensor_data, FieldCheckMask enabled_checks, FieldCounts& counts)
+{
+  FieldCheckMask missing = 0;
+  if ((enabled_checks & FieldCheckBit(kCheckMovingObject)) != 0)
+  {
+    counts.checked[kCheckMovingObject]++;
+    if (sensor_data.moving_object().empty())
+    {
+      counts.missing[kCheckMovingObject]++;
+      missing |= FieldCheckBit(kCheckMovingObject);
+    }
+  }
+  if ((enabled_checks & kFeatureDataChecks) != 0)
+  {
+    missing |= CheckDetectionArrays(sensor_data.feature_data(), enabled_checks, counts);
+  }
+  return missing;
+}
+
+FieldCheckMask CheckSensorDataFields(const osi3::SensorData& sensor_data, FieldCheckMask enabled_checks, FieldCounts& counts)
+{
+  FieldCheckMask missing = CheckFrameArrays(sensor_data, enabled_checks, counts);
+  if ((enabled_checks & FieldCheckBit(kCheckMovingObject)) != 0 && (enabled_checks & kMovingObjectChecks) != 0)
+  {
+    for (const auto& moving_object : sensor_data.moving_object())
+    {
+      missing |= CheckMovingObject(moving_object, enabled_checks, counts);
+    }
+  }
+  if ((enabled_checks & kLidarChecks) != 0)
+  {
+    for (const auto& lidar_sensor : sensor_data.feature_data().lidar_sensor())
+    {
+      missing |= CheckLidarDetections(lidar_sensor, 0, lidar_sensor.detection_size(), enabled_checks, counts);
+    }
+  }
+  if ((enabled_checks & kRadarChecks) != 0)
+  {
+    for (const auto& radar_sensor : sensor_data.feature_data().radar_sensor())
+    {
+      missing |= CheckRadarDetections(radar_sensor, 0, radar_sensor.detection_size(), enabled_checks, counts);
+    }
+  }
+  return missing;
+}
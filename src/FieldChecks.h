@@ -0,0 +1,127 @@
+//
+// Copyright 2023 BMW AG
+// SPDX-License-Identifier: MPL-2.0
+//
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "osi_featuredata.pb.h"
+#include "osi_sensordata.pb.h"
+
+/*
+ * Field Checks
+ *
+ * Every field that can be requested in the check file has an entry in
+ * FieldCheck.  The check file is translated into a bit mask once during
+ * initialization, so the per-frame checks do not compare any strings.
+ */
+
+enum FieldCheck
+{
+  kCheckMovingObject,
+  kCheckMovingObjectBase,
+  kCheckMovingObjectBaseDimension,
+  kCheckMovingObjectBasePosition,
+  kCheckMovingObjectBaseOrientation,
+  kCheckMovingObjectBaseVelocity,
+  kCheckMovingObjectBaseAcceleration,
+  kCheckMovingObjectBaseOrientationRate,
+  kCheckMovingObjectBaseOrientationAcceleration,
+  kCheckMovingObjectBaseBasePolygon,
+  kCheckLidarDetection,
+  kCheckLidarDetectionPosition,
+  kCheckLidarDetectionIntensity,
+  kCheckLidarDetectionExistenceProbability,
+  kCheckRadarDetection,
+  kCheckRadarDetectionPosition,
+  kCheckRadarDetectionRcs,
+  kCheckRadarDetectionExistenceProbability,
+  kFieldCheckCount
+};
+
+typedef uint64_t FieldCheckMask;
+
+extern const char* const kFieldCheckNames[kFieldCheckCount];
+
+inline FieldCheckMask FieldCheckBit(FieldCheck check)
+{
+  return 1ULL << static_cast<unsigned>(check);
+}
+
+const FieldCheckMask kMovingObjectChecks = FieldCheckBit(kCheckMovingObjectBase) | FieldCheckBit(kCheckMovingObjectBaseDimension) |
+                                           FieldCheckBit(kCheckMovingObjectBasePosition) | FieldCheckBit(kCheckMovingObjectBaseOrientation) |
+                                           FieldCheckBit(kCheckMovingObjectBaseVelocity) | FieldCheckBit(kCheckMovingObjectBaseAcceleration) |
+                                           FieldCheckBit(kCheckMovingObjectBaseOrientationRate) | FieldCheckBit(kCheckMovingObjectBaseOrientationAcceleration) |
+                                           FieldCheckBit(kCheckMovingObjectBaseBasePolygon);
+const FieldCheckMask kLidarChecks = FieldCheckBit(kCheckLidarDetection) | FieldCheckBit(kCheckLidarDetectionPosition) | FieldCheckBit(kCheckLidarDetectionIntensity) |
+                                    FieldCheckBit(kCheckLidarDetectionExistenceProbability);
+const FieldCheckMask kRadarChecks = FieldCheckBit(kCheckRadarDetection) | FieldCheckBit(kCheckRadarDetectionPosition) | FieldCheckBit(kCheckRadarDetectionRcs) |
+                                    FieldCheckBit(kCheckRadarDetectionExistenceProbability);
+const FieldCheckMask kFeatureDataChecks = kLidarChecks | kRadarChecks;
+
+/* Translate a check file entry into a field check, returns false for unknown entries */
+bool ParseFieldCheck(const std::string& name, FieldCheck& check);
+
+/*
+ * Number of checked and missing occurrences per field.  Moving object fields
+ * count objects, detection fields count detections and the array entries
+ * (moving_object and the detection arrays) count frames.
+ */
+struct FieldCounts
+{
+  uint64_t checked[kFieldCheckCount] = {};
+  uint64_t missing[kFieldCheckCount] = {};
+};
+
+/*
+ * Field counts accumulated over a run.  frames_missing counts the frames
+ * in which a field was missing at least once.  The arrays are fixed size,
+ * so adding a frame does not allocate.
+ */
+struct FieldStatistics
+{
+  uint64_t checked[kFieldCheckCount] = {};
+  uint64_t missing[kFieldCheckCount] = {};
+  uint64_t frames_missing[kFieldCheckCount] = {};
+
+  /* Accumulate the counts of one frame for the enabled checks */
+  void Add(const FieldCounts& counts, FieldCheckMask enabled_checks);
+  /* Fraction of checked occurrences in which the field was present, 1 if it was never checked */
+  double FillRate(FieldCheck check) const;
+};
+
+/* What a field check counts: "moving objects", "detections" or "frames" */
+const char* FieldCheckUnit(FieldCheck check);
+
+/* Summary of a field for reports, e.g. "missing in 3 of 300 moving objects (fill rate 99.00 %) in 3 frames" */
+std::string DescribeFieldStatistics(const FieldStatistics& statistics, FieldCheck check);
+
+/* Report lines of the fields found missing, as printed by the FMU and OSITraceChecker */
+struct FieldReport
+{
+  std::vector<std::string> lines;
+  bool failed = false;  // a fill rate is below min_fill_rate
+};
+
+/* Fields with a fill rate below min_fill_rate are reported as "::error title=MissingField::", the others found missing as "::warning title=FillRate::" */
+FieldReport ReportFieldStatistics(const FieldStatistics& statistics, double min_fill_rate);
+
+/* Checks of the first level fields of a detected moving object, returns the mask of missing fields */
+FieldCheckMask CheckMovingObject(const osi3::DetectedMovingObject& moving_object, FieldCheckMask enabled_checks, FieldCounts& counts);
+
+/* Checks that every lidar and radar sensor in feature_data carries a non-empty detection array */
+FieldCheckMask CheckDetectionArrays(const osi3::FeatureData& feature_data, FieldCheckMask enabled_checks, FieldCounts& counts);
+
+/* Checks of the detections [begin, end) of one sensor, every required field has to be present and finite */
+FieldCheckMask CheckLidarDetections(const osi3::LidarDetectionData& lidar_sensor, int begin, int end, FieldCheckMask enabled_checks, FieldCounts& counts);
+FieldCheckMask CheckRadarDetections(const osi3::RadarDetectionData& radar_sensor, int begin, int end, FieldCheckMask enabled_checks, FieldCounts& counts);
+
+/* Frame level checks: a non-empty moving_object array and the detection arrays of feature_data */
+FieldCheckMask CheckFrameArrays(const osi3::SensorData& sensor_data, FieldCheckMask enabled_checks, FieldCounts& counts);
+
+/* All checks of a frame in one call, the counts equal those of the FMU checking the frame without step time budget and sampling */
+FieldCheckMask CheckSensorDataFields(const osi3::SensorData& sensor_data, FieldCheckMask enabled_checks, FieldCounts& counts);
@@ -0,0 +1,218 @@
+//
+// Copyright 2023 BMW AG
+// SPDX-License-Identifier: MPL-2.0
+//
+
+#include "FrameCapture.h"
+
+#include <mutex>
+
+namespace
+{
+
+const size_t kSizePrefixBytes = 4;
+
+}  // namespace
+
+FrameCapture::~FrameCapture()
+{
+  Close();
+}
+
+bool FrameCapture::Open(const std::string& path, uint64_t first_occurrences, uint64_t occurrence_stride, uint64_t max_bytes, size_t queue_frames)
+{
+  Close();
+  file_.open(path, std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!file_.is_open())
+  {
+    return false;
+  }
+  path_ = path;
+  first_occurrences_ = first_occurrences;
+  occurrence_stride_ = occurrence_stride;
+  max_bytes_ = max_bytes;
+  occurrences_.clear();
+  queued_bytes_ = 0;
+  dropped_queue_full_ = 0;
+  dropped_size_limit_ = 0;
+  written_frames_.store(0, std::memory_order_relaxed);
+  written_bytes_.store(0, std::memory_order_relaxed);
+  dropped_write_error_.store(0, std::memory_order_relaxed);
+
+  size_t slot_count = 1;
+  while (slot_count < queue_frames)
+  {
+    slot_count <<= 1U;
+  }
+  slots_.resize(slot_count);
+  mask_ = slot_count - 1;
+  head_.store(0, std::memory_order_relaxed);
+  tail_.store(0, std::memory_order_relaxed);
+  stop_.store(false, std::memory_order_relaxed);
+  sleeping_.store(false, std::memory_order_relaxed);
+  thread_ = std::thread(&FrameCapture::Run, this);
+  return true;
+}
+
+void FrameCapture::Close()
+{
+  if (thread_.joinable())
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_.store(true, std::memory_order_release);
+    }
+    wake_.notify_one();
+    thread_.join();
+  }
+  if (file_.is_open())
+  {
+    file_.close();
+  }
+}
+
+bool FrameCapture::CountOccurrence(size_t field)
+{
+  if (field >= occurrences_.size())
+  {
+    occurrences_.resize(field + 1, 0);
+  }
+  const uint64_t occurrence = ++occurrences_[field];
+  if (occurrence <= first_occurrences_)
+  {
+    return true;
+  }
+  return occurrence_stride_ > 0 && (occurrence - first_occurrences_) % occurrence_stride_ == 0;
+}
+
+void FrameCapture::Capture(const void* buffer, size_t size)
+{
+  if (!IsOpen())
+  {
+    return;
+  }
+  if (queued_bytes_ + kSizePrefixBytes + size > max_bytes_)
+  {
+    dropped_size_limit_++;
+    return;
+  }
+  const size_t head = head_.load(std::memory_order_relaxed);
+  if (head - tail_.load(std::memory_order_acquire) >= slots_.size())
+  {
+    dropped_queue_full_++;
+    return;
+  }
+  const auto length = static_cast<uint32_t>(size);
+  const char prefix[kSizePrefixBytes] = {static_cast<char>(length & 0xFFU),
+                                         static_cast<char>((length >> 8U) & 0xFFU),
+                                         static_cast<char>((length >> 16U) & 0xFFU),
+                                         static_cast<char>((length >> 24U) & 0xFFU)};
+  std::string& slot = slots_[head & mask_];
+  slot.assign(prefix, kSizePrefixBytes);
+  slot.append(static_cast<const char*>(buffer), size);
+  queued_bytes_ += kSizePrefixBytes + size;
+
+  /* Sequentially consistent, so either the sleeping thread sees the frame or the flag is seen here */
+  head_.store(head + 1, std::memory_order_seq_cst);
+  if (sleeping_.load(std::memory_order_seq_cst))
+  {
+    Wake();
+  }
+}
+
+FrameCapture::Statistics FrameCapture::GetStatistics() const
+{
+  Statistics statistics;
+  statistics.captured_frames = written_frames_.load(std::memory_order_acquire);
+  statistics.captured_bytes = written_bytes_.load(std::memory_order_acquire);
+  statistics.dropped_queue_full = dropped_queue_full_;
+  statistics.dropped_size_limit = dropped_size_limit_;
+  statistics.dropped_write_error = dropped_write_error_.load(std::memory_order_acquire);
+  return statistics;
+}
+
+void FrameCapture::ReleaseIdleSlots()
+{
+  /* Slots from head up to the oldest queued one belong to the producer */
+  const size_t head = head_.load(std::memory_order_relaxed);
+  const size_t end = tail_.load(std::memory_order_acquire) + slots_.size();
+  for (size_t slot = head; slot != end; slot++)
+  {
+    std::string().swap(slots_[slot & mask_]);
+  }
+}
+
+size_t FrameCapture::MemoryUsage() const
+{
+  size_t bytes = occurrences_.capacity() * sizeof(uint64_t);
+  for (const std::string& slot : slots_)
+  {
+    bytes += slot.capacity();
+  }
+  return bytes;
+}
+
+void FrameCapture::Wake()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);  // the writer thread is either before its check of head_ or waiting
+  }
+  wake_.notify_one();
+}
+
+void FrameCapture::Run()
+{
+  /* Frames written since the last flush only count as captured once the flush succeeded */
+  uint64_t pending_frames = 0;
+  uint64_t pending_bytes = 0;
+  for (;;)
+  {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail == head_.load(std::memory_order_seq_cst))
+    {
+      if (pending_frames > 0)
+      {
+        file_.flush();
+        if (file_.good())
+        {
+          written_frames_.fetch_add(pending_frames, std::memory_order_release);
+          written_bytes_.fetch_add(pending_bytes, std::memory_order_release);
+        }
+        else
+        {
+          dropped_write_error_.fetch_add(pending_frames, std::memory_order_release);
+        }
+        pending_frames = 0;
+        pending_bytes = 0;
+      }
+      std::unique_lock<std::mutex> lock(mutex_);
+      if (stop_.load(std::memory_order_acquire))
+      {
+        break;
+      }
+      sleeping_.store(true, std::memory_order_seq_cst);
+      wake_.wait(lock, [this, tail] { return head_.load(std::memory_order_seq_cst) != tail || stop_.load(std::memory_order_acquire); });
+      sleeping_.store(false, std::memory_order_relaxed);
+      continue;
+    }
+
+    /* After an error the stream stays failed, so the frames still queued are dropped as well */
+    const std::string& slot = slots_[tail & mask_];
+    if (file_.good())
+    {
+      file_.write(slot.data(), static_cast<std::streamsize>(slot.size()));
+    }
+    if (file_.good())
+    {
+      pending_frames++;
+      pending_bytes += slot.size();
+    }
+    else
+    {
+      dropped_write_error_.fetch_add(pending_frames + 1, std::memory_order_release);
+      pending_frames = 0;
+      pending_bytes = 0;
+    }
+    tail_.store(tail + 1, std::memory_order_release);
+  }
+}
@@ -0,0 +1,103 @@
+//
+// Copyright 2023 BMW AG
+// SPDX-License-Identifier: MPL-2.0
+//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+ * Capture of offending frames
+ *
+ * Frames in which a field is missing are written unchanged to a trace file,
+ * each preceded by its size as 32 bit little-endian integer like in binary
+ * OSI trace files, so the problem can be reproduced without the scenario.
+ *
+ * Captures are rate-limited per field: the first first_occurrences frames
+ * in which a field is missing are captured, after that every
+ * occurrence_stride-th one.  The frame is copied into a slot of a bounded
+ * single-producer single-consumer ring and written by a background thread;
+ * if the ring is full or the file would exceed max_bytes, the frame is
+ * dropped and counted instead of blocking the caller.  The slots keep their
+ * allocation, so no memory is allocated once frames of the largest size
+ * have been captured.
+ *
+ * The writer thread sleeps on a condition variable while the ring is empty,
+ * woken like the thread of AsyncLogger.  Frames count as captured once they
+ * were flushed to the file, frames lost to a write or flush error are
+ * counted as dropped.
+ */
+class FrameCapture
+{
+public:
+  struct Statistics
+  {
+    uint64_t captured_frames = 0;
+    uint64_t captured_bytes = 0;
+    uint64_t dropped_queue_full = 0;
+    uint64_t dropped_size_limit = 0;
+    uint64_t dropped_write_error = 0;
+  };
+
+  FrameCapture() = default;
+  ~FrameCapture();
+  FrameCapture(const FrameCapture&) = delete;
+  FrameCapture& operator=(const FrameCapture&) = delete;
+
+  /* Creates (or truncates) the trace file and starts the writer thread, false if the file cannot be written */
+  bool Open(const std::string& path, uint64_t first_occurrences, uint64_t occurrence_stride, uint64_t max_bytes, size_t queue_frames = 64);
+
+  /* Writes all queued frames, stops the writer thread and closes the file */
+  void Close();
+  bool IsOpen() const { return thread_.joinable(); }
+
+  /* Counts a frame in which the field is missing, true if the rate limit of the field allows a capture */
+  bool CountOccurrence(size_t field);
+
+  /* Queues a copy of the frame, never blocks */
+  void Capture(const void* buffer, size_t size);
+
+  /* Frees the copies held by slots the writer thread is done with, called by the producer */
+  void ReleaseIdleSlots();
+  size_t MemoryUsage() const;
+
+  /* Frames written so far, complete once the capture is closed */
+  Statistics GetStatistics() const;
+  const std::string& Path() const { return path_; }
+
+private:
+  void Wake();
+  void Run();
+
+  std::string path_;
+  std::ofstream file_;
+  uint64_t first_occurrences_ = 0;
+  uint64_t occurrence_stride_ = 0;
+  uint64_t max_bytes_ = 0;
+  std::vector<uint64_t> occurrences_;
+  uint64_t queued_bytes_ = 0;  // counted against max_bytes when the frame is queued
+  uint64_t dropped_queue_full_ = 0;
+  uint64_t dropped_size_limit_ = 0;
+
+  std::vector<std::string> slots_;
+  size_t mask_ = 0;
+  std::atomic<size_t> head_{0};
+  std::atomic<size_t> tail_{0};
+  std::atomic<bool> stop_{false};
+  std::atomic<bool> sleeping_{false};  // the writer thread waits for frames on wake_
+  std::atomic<uint64_t> written_frames_{0};
+  std::atomic<uint64_t> written_bytes_{0};
+  std::atomic<uint64_t> dropped_write_error_{0};
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::thread thread_;
+};
@@ -0,0 +1,110 @@
+//
+// Copyright 2023 BMW AG
+// SPDX-License-Identifier: MPL-2.0
+//
+
+#include "MissingFieldMap.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+namespace
+{
+
+const double kPi = 3.14159265358979323846;
+
+}  // namespace
+
+void MissingFieldMap::Configure(size_t range_bins, size_t azimuth_bins, double max_range)
+{
+  if (range_bins == 0 || azimuth_bins == 0 || !(max_range > 0.0))
+  {
+    Disable();
+    return;
+  }
+  range_bins_ = range_bins;
+  azimuth_bins_ = azimuth_bins;
+  max_range_ = max_range;
+  range_scale_ = static_cast<double>(range_bins) / max_range;
+  azimuth_scale_ = static_cast<double>(azimuth_bins) / (2.0 * kPi);
+  objects_.assign((range_bins + 1) * azimuth_bins, 0);
+  missing_.assign(objects_.size(), 0);
+  Reset();
+}
+
+void MissingFieldMap::Disable()
+{
+  objects_.clear();
+  missing_.clear();
+  Reset();
+}
+
+void MissingFieldMap::Reset()
+{
+  std::fill(objects_.begin(), objects_.end(), 0);
+  std::fill(missing_.begin(), missing_.end(), 0);
+  missing_objects_ = 0;
+  unplaced_objects_ = 0;
+}
+
+void MissingFieldMap::Add(const osi3::DetectedMovingObject& moving_object, bool missing)
+{
+  missing_objects_ += static_cast<uint64_t>(missing);
+  if (!moving_object.base().has_position())
+  {
+    unplaced_objects_++;
+    return;
+  }
+  /* Already in sensor coordinates */
+  const double x = moving_object.base().position().x();
+  const double y = moving_object.base().position().y();
+
+  const double range = std::sqrt(x * x + y * y) * range_scale_;
+  const double azimuth = (std::atan2(y, x) + kPi) * azimuth_scale_;
+  if (!(range >= 0.0) || !(azimuth >= 0.0))
+  {
+    unplaced_objects_++;  // non-finite position
+    return;
+  }
+  const auto range_bin = static_cast<size_t>(std::min(range, static_cast<double>(range_bins_)));
+  const size_t azimuth_bin = std::min(static_cast<size_t>(azimuth), azimuth_bins_ - 1);
+  const size_t bin = range_bin * azimuth_bins_ + azimuth_bin;
+  objects_[bin]++;
+  missing_[bin] += static_cast<uint64_t>(missing);
+}
+
+bool MissingFieldMap::WriteCsv(const std::string& path) const
+{
+  std::ofstream file(path, std::ios::out | std::ios::trunc);
+  if (!file.is_open())
+  {
+    return false;
+  }
+  const double range_width = max_range_ / static_cast<double>(range_bins_);
+  const double azimuth_width = 360.0 / static_cast<double>(azimuth_bins_);
+  file << "range_min,range_max,azimuth_min,azimuth_max,objects,objects_missing_fields\n";
+  for (size_t range_bin = 0; range_bin <= range_bins_; range_bin++)
+  {
+    for (size_t azimuth_bin = 0; azimuth_bin < azimuth_bins_; azimuth_bin++)
+    {
+      const size_t bin = range_bin * azimuth_bins_ + azimuth_bin;
+      if (objects_[bin] == 0)
+      {
+        continue;
+      }
+      file << static_cast<double>(range_bin) * range_width << ",";
+      if (range_bin < range_bins_)
+      {
+        file << static_cast<double>(range_bin + 1) * range_width;
+      }
+      else
+      {
+        file << "inf";
+      }
+      file << "," << static_cast<double>(azimuth_bin) * azimuth_width - 180.0 << "," << static_cast<double>(azimuth_bin + 1) * azimuth_width - 180.0 << ","
+           << objects_[bin] << "," << missing_[bin] << "\n";
+    }
+  }
+  return file.good();
+}
@@ -0,0 +1,59 @@
+//
+// Copyright 2023 BMW AG
+// SPDX-License-Identifier: MPL-2.0
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "osi_sensordata.pb.h"
+
+/*
+ * Polar map of objects with missing fields
+ *
+ * Checked moving objects are counted in a fixed grid of range and azimuth
+ * bins around the sensor, so coverage gaps e.g. at the edges of the field
+ * of view become visible.  Detected objects are given in the sensor
+ * coordinate system defined by the mounting_position of the frame, so the
+ * bin follows directly from the distance and azimuth of base.position in
+ * the x-y plane of the sensor.
+ * Objects beyond max_range are counted in an additional range bin.  The
+ * grid is allocated once in Configure(), adding an object is O(1) and
+ * does not allocate.
+ */
+class MissingFieldMap
+{
+public:
+  /* Disabled until configured, max_range <= 0 or no bins leave it disabled */
+  void Configure(size_t range_bins, size_t azimuth_bins, double max_range);
+  void Disable();
+  bool IsEnabled() const { return !objects_.empty(); }
+  /* Clear the counts, the grid is kept */
+  void Reset();
+
+  void Add(const osi3::DetectedMovingObject& moving_object, bool missing);
+
+  uint64_t MissingObjects() const { return missing_objects_; }
+  /* Objects without a finite base.position, they cannot be mapped */
+  uint64_t UnplacedObjects() const { return unplaced_objects_; }
+  size_t MemoryUsage() const { return (objects_.capacity() + missing_.capacity()) * sizeof(uint64_t); }
+
+  /* One line per bin with objects: range_min,range_max,azimuth_min,azimuth_max,objects,objects_missing_fields (m and deg) */
+  bool WriteCsv(const std::string& path) const;
+
+private:
+  size_t range_bins_ = 0;
+  size_t azimuth_bins_ = 0;
+  double max_range_ = 0.0;
+  double range_scale_ = 0.0;    // bins per m
+  double azimuth_scale_ = 0.0;  // bins per rad
+
+  std::vector<uint64_t> objects_;  // (range_bins + 1) x azimuth_bins, row-major by range
+  std::vector<uint64_t> missing_;
+  uint64_t missing_objects_ = 0;
+  uint64_t unplaced_objects_ = 0;
+};
@@ -40,6 +40,7 @@
 #endif
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <cstdint>
 #include <iostream>
@@ -47,14 +48,24 @@
 
 using namespace std;
 
+/* Rate limits of the frame capture, after the ones of the field checks */
+const size_t kCaptureMissedObjects = kFieldCheckCount;
+const size_t kCaptureDynamicFields = kFieldCheckCount + 1;
+
 #ifdef PRIVATE_LOG_PATH
-ofstream COSMPDummySensor::private_log_file;
+ofstream OSIFieldChecker::private_log_file;
+std::mutex OSIFieldChecker::private_log_mutex;
 #endif
 
 /*
  * ProtocolBuffer Accessors
  */
 
+double TimestampToSeconds(const osi3::Timestamp& timestamp)
+{
+  return static_cast<double>(timestamp.seconds()) + static_cast<double>(timestamp.nanos()) * 1e-9;
+}
+
 void* DecodeIntegerToPointer(fmi2Integer hi, fmi2Integer lo)
 {
 #if PTRDIFF_MAX == INT64_MAX
@@ -100,13 +111,43 @@ void EncodePointerToInteger(const void* ptr, fmi2Integer& hi, fmi2Integer& lo)
 #endif
 }
 
-bool OSIFieldChecker::GetFmiSensorDataIn(osi3::SensorData& data)
+bool OSIFieldChecker::GetFmiSensorDataInBuffer(const void*& buffer, int& size)
 {
   if (integer_vars_[FMI_INTEGER_SENSORDATA_IN_SIZE_IDX] > 0)
   {
-    void* buffer = DecodeIntegerToPointer(integer_vars_[FMI_INTEGER_SENSORDATA_IN_BASEHI_IDX], integer_vars_[FMI_INTEGER_SENSORDATA_IN_BASELO_IDX]);
-    NormalLog("OSMP", "Got %08X %08X, reading from %p ...", integer_vars_[FMI_INTEGER_SENSORDATA_IN_BASEHI_IDX], integer_vars_[FMI_INTEGER_SENSORDATA_IN_BASELO_IDX], buffer);
-    data.ParseFromArray(buffer, integer_vars_[FMI_INTEGER_SENSORDATA_IN_SIZE_IDX]);
+    buffer = DecodeIntegerToPointer(integer_vars_[FMI_INTEGER_SENSORDATA_IN_BASEHI_IDX], integer_vars_[FMI_INTEGER_SENSORDATA_IN_BASELO_IDX]);
+    size = integer_vars_[FMI_INTEGER_SENSORDATA_IN_SIZE_IDX];
+    NormalLog<kLogOsmp>("Got %08X %08X, reading from %p ...", integer_vars_[FMI_INTEGER_SENSORDATA_IN_BASEHI_IDX], integer_vars_[FMI_INTEGER_SENSORDATA_IN_BASELO_IDX], buffer);
+    return true;
+  }
+  return false;
+}
+
+bool OSIFieldChecker::GetFmiSensorDataBatchInBuffer(const void*& buffer, int& size)
+{
+  if (integer_vars_[FMI_INTEGER_SENSORDATA_BATCH_IN_SIZE_IDX] > 0)
+  {
+    buffer = DecodeIntegerToPointer(integer_vars_[FMI_INTEGER_SENSORDATA_BATCH_IN_BASEHI_IDX], integer_vars_[FMI_INTEGER_SENSORDATA_BATCH_IN_BASELO_IDX]);
+    size = integer_vars_[FMI_INTEGER_SENSORDATA_BATCH_IN_SIZE_IDX];
+    NormalLog<kLogOsmp>("Got batch %08X %08X, reading from %p ...",
+                        integer_vars_[FMI_INTEGER_SENSORDATA_BATCH_IN_BASEHI_IDX],
+                        integer_vars_[FMI_INTEGER_SENSORDATA_BATCH_IN_BASELO_IDX],
+                        buffer);
+    return true;
+  }
+  return false;
+}
+
+bool OSIFieldChecker::GetFmiSensorViewInBuffer(const void*& buffer, int& size)
+{
+  if (integer_vars_[FMI_INTEGER_SENSORVIEW_IN_SIZE_IDX] > 0)
+  {
+    buffer = DecodeIntegerToPointer(integer_vars_[FMI_INTEGER_SENSORVIEW_IN_BASEHI_IDX], integer_vars_[FMI_INTEGER_SENSORVIEW_IN_BASELO_IDX]);
+    size = integer_vars_[FMI_INTEGER_SENSORVIEW_IN_SIZE_IDX];
+    NormalLog<kLogOsmp>("Got SensorView %08X %08X, reading from %p ...",
+                        integer_vars_[FMI_INTEGER_SENSORVIEW_IN_BASEHI_IDX],
+                        integer_vars_[FMI_INTEGER_SENSORVIEW_IN_BASELO_IDX],
+                        buffer);
     return true;
   }
   return false;
@@ -114,14 +155,24 @@ bool OSIFieldChecker::GetFmiSensorDataIn(osi3::SensorData& data)
 
 void OSIFieldChecker::SetFmiSensorDataOut(const osi3::SensorData& data)
 {
-  data.SerializeToString(current_output_buffer_);
+  data.SerializeToString(current_output_buffer_.get());
+  PublishFmiSensorDataOut();
+}
+
+void OSIFieldChecker::SetFmiSensorDataOut(const void* buffer, int size)
+{
+  current_output_buffer_->assign(static_cast<const char*>(buffer), static_cast<size_t>(size));
+  PublishFmiSensorDataOut();
+}
+
+void OSIFieldChecker::PublishFmiSensorDataOut()
+{
   EncodePointerToInteger(current_output_buffer_->data(), integer_vars_[FMI_INTEGER_SENSORDATA_OUT_BASEHI_IDX], integer_vars_[FMI_INTEGER_SENSORDATA_OUT_BASELO_IDX]);
   integer_vars_[FMI_INTEGER_SENSORDATA_OUT_SIZE_IDX] = (fmi2Integer)current_output_buffer_->length();
-  NormalLog("OSMP",
-            "Providing %08X %08X, writing from %p ...",
-            integer_vars_[FMI_INTEGER_SENSORDATA_OUT_BASEHI_IDX],
-            integer_vars_[FMI_INTEGER_SENSORDATA_OUT_BASELO_IDX],
-            current_output_buffer_->data());
+  NormalLog<kLogOsmp>("Providing %08X %08X, writing from %p ...",
+                      integer_vars_[FMI_INTEGER_SENSORDATA_OUT_BASEHI_IDX],
+                      integer_vars_[FMI_INTEGER_SENSORDATA_OUT_BASELO_IDX],
+                      static_cast<const void*>(current_output_buffer_->data()));
   swap(current_output_buffer_, last_output_buffer_);
 }
 
@@ -162,6 +213,28 @@ fmi2Status OSIFieldChecker::DoInit()
     string_var = "";
   }
 
+  /* Parameter start values */
+  integer_vars_[FMI_INTEGER_TEMPORAL_MAX_TRACKED_IDS_IDX] = 65536;
+  integer_vars_[FMI_INTEGER_TEMPORAL_MAX_ABSENT_FRAMES_IDX] = 5;
+  integer_vars_[FMI_INTEGER_SAMPLE_FRAME_STRIDE_IDX] = 1;
+  integer_vars_[FMI_INTEGER_SAMPLE_OBJECT_STRIDE_IDX] = 1;
+  integer_vars_[FMI_INTEGER_SAMPLE_STABLE_FRAMES_IDX] = 50;
+  integer_vars_[FMI_INTEGER_CAPTURE_FIRST_OCCURRENCES_IDX] = 5;
+  integer_vars_[FMI_INTEGER_CAPTURE_OCCURRENCE_STRIDE_IDX] = 100;
+  integer_vars_[FMI_INTEGER_CAPTURE_MAX_MEGABYTES_IDX] = 64;
+  integer_vars_[FMI_INTEGER_MAX_MISSING_FIELD_NAMES_IDX] = 1024;
+  integer_vars_[FMI_INTEGER_MISSING_MAP_RANGE_BINS_IDX] = 27;
+  integer_vars_[FMI_INTEGER_MISSING_MAP_AZIMUTH_BINS_IDX] = 72;
+  real_vars_[FMI_REAL_CHECK_COVERAGE_IDX] = 1.0;
+  real_vars_[FMI_REAL_CHECK_START_TIME_IDX] = 0.5;
+  real_vars_[FMI_REAL_MIN_FILL_RATE_IDX] = 1.0;
+  real_vars_[FMI_REAL_NOMINAL_RANGE_IDX] = 135.0;
+  real_vars_[FMI_REAL_OBJECT_RECALL_IDX] = 1.0;
+  for (int i = 0; i < kFieldCheckCount; i++)
+  {
+    real_vars_[FMI_REAL_FIELD_FILL_RATE_OFFSET + i] = 1.0;
+  }
+
   return fmi2OK;
 }
 
@@ -177,118 +250,771 @@ fmi2Status OSIFieldChecker::DoEnterInitializationMode()
 
 fmi2Status OSIFieldChecker::DoExitInitializationMode()
 {
-  fstream osi_check_file;
-  const std::string check_file = FmiCheckFile();
-  osi_check_file.open(check_file, ios::in);  // open a file to perform read operation using file object
-  if (osi_check_file.is_open())
-  {  // checking whether the file is open
-    string current_line;
-    while (getline(osi_check_file, current_line))
-    {  // read data from file object and put it into string.
-      expected_osi_fields_.insert(current_line);
+  /*
+   * Text check files and compiled profiles are parsed once per process and
+   * shared by all instances.  After Reset() the profile is only loaded
+   * again if check_file was changed.
+   */
+  string error;
+  if (!check_profile_ || loaded_check_file_ != FmiCheckFile())
+  {
+    loaded_check_file_ = FmiCheckFile();
+    check_profile_ = CheckProfile::Load(loaded_check_file_, error);
+    if (!check_profile_)
+    {
+      std::cerr << "OSI check file not found! (" << error << ")" << std::endl;
+      enabled_checks_ = 0;
+      check_timestamp_monotonic_ = false;
+      check_tracking_id_persistence_ = false;
+      check_object_recall_ = false;
+      return fmi2OK;
+    }
+    if (check_profile_->IsCompiled() && check_profile_->OsiVersion() != OSI_VERSION)
+    {
+      std::cerr << "Check profile was compiled for OSI " << check_profile_->OsiVersion() << ", the FMU uses OSI " << OSI_VERSION << std::endl;
+    }
+    loaded_descriptor_set_.clear();  // field paths of the dynamic checker have to be resolved again
+  }
+
+  enabled_checks_ = check_profile_->EnabledChecks();
+  check_timestamp_monotonic_ = check_profile_->Contains(kCheckTemporalTimestamp);
+  check_tracking_id_persistence_ = check_profile_->Contains(kCheckTemporalTrackingId);
+  check_object_recall_ = check_profile_->Contains(kCheckObjectRecall);
+  if (check_timestamp_monotonic_ || check_tracking_id_persistence_)
+  {
+    temporal_checker_.Configure(static_cast<size_t>(max(FmiTemporalMaxTrackedIds(), 1)), static_cast<uint32_t>(max(FmiTemporalMaxAbsentFrames(), 0)));
+  }
+
+  if (loaded_descriptor_set_ != FmiDescriptorSet())
+  {
+    loaded_descriptor_set_ = FmiDescriptorSet();
+    dynamic_field_checks_.clear();
+    if (FmiDescriptorSet().empty())
+    {
+      dynamic_field_checker_.Unload();
+    }
+    else if (dynamic_field_checker_.Load(ResourcePath(FmiDescriptorSet()), "osi3.SensorData", error))
+    {
+      std::set<string> field_paths;
+      for (const auto& entry : check_profile_->Entries())
+      {
+        const string name = entry.ToString();
+        if (name != kCheckTemporalTimestamp && name != kCheckTemporalTrackingId && name != kCheckObjectRecall)
+        {
+          field_paths.insert(name);
+        }
+      }
+      for (const auto& unresolved : dynamic_field_checker_.SetFieldPaths(field_paths))
+      {
+        std::cerr << loaded_check_file_ << ": unknown entry " << unresolved << ", not a field path of osi3.SensorData in " << FmiDescriptorSet() << std::endl;
+      }
+
+      /* Results of the fields known to the generated checks go into the field statistics */
+      for (const auto& result : dynamic_field_checker_.GetResults())
+      {
+        FieldCheck check = kCheckMovingObject;
+        dynamic_field_checks_.push_back(ParseFieldCheck(result.name, check) ? static_cast<int>(check) : -1);
+      }
     }
-    osi_check_file.close();  // close the file object.
+    else
+    {
+      std::cerr << error << ", falling back to the linked OSI version" << std::endl;
+    }
+  }
+  if (dynamic_field_checker_.IsLoaded())
+  {
+    DisableUnavailableDynamicChecks();
+  }
+
+  OpenFrameCapture();
+  if (FmiMissingMapFile().empty() || dynamic_field_checker_.IsLoaded())
+  {
+    missing_field_map_.Disable();
   }
   else
   {
-    std::cerr << "OSI check file not found!" << std::endl;
+    missing_field_map_.Configure(static_cast<size_t>(max(FmiMissingMapRangeBins(), 0)), static_cast<size_t>(max(FmiMissingMapAzimuthBins(), 0)), FmiNominalRange());
+    if (!missing_field_map_.IsEnabled())
+    {
+      std::cerr << "Missing field map needs a positive nominalrange and number of bins, it is not written" << std::endl;
+    }
   }
   return fmi2OK;
 }
 
-fmi2Status OSIFieldChecker::DoCalc(fmi2Real current_communication_point, fmi2Real communication_step_size)
+/* The checks that need the generated OSI classes do not run on dynamic messages, they are turned off with a warning */
+void OSIFieldChecker::DisableUnavailableDynamicChecks()
+{
+  if (check_timestamp_monotonic_ || check_tracking_id_persistence_ || check_object_recall_)
+  {
+    std::cerr << "Temporal and object recall checks are not available with descriptor_set, they are disabled" << std::endl;
+    check_timestamp_monotonic_ = false;
+    check_tracking_id_persistence_ = false;
+    check_object_recall_ = false;
+  }
+  if (FmiSampleFrameStride() > 1 || FmiSampleObjectStride() > 1)
+  {
+    std::cerr << "Sampling is not available with descriptor_set, every frame is checked completely" << std::endl;
+  }
+  if (FmiStepTimeBudgetUs() > 0)
+  {
+    std::cerr << "Checks are not scheduled within step_time_budget_us with descriptor_set, only deadline misses are counted" << std::endl;
+  }
+  if (!FmiMissingMapFile().empty())
+  {
+    std::cerr << "Missing field map is not available with descriptor_set, it is not written" << std::endl;
+  }
+}
+
+void OSIFieldChecker::OpenFrameCapture()
+{
+  frame_capture_.Close();
+  if (FmiCaptureFile().empty())
+  {
+    return;
+  }
+  if (!frame_capture_.Open(FmiCaptureFile(),
+                           static_cast<uint64_t>(max(FmiCaptureFirstOccurrences(), 0)),
+                           static_cast<uint64_t>(max(FmiCaptureOccurrenceStride(), 0)),
+                           static_cast<uint64_t>(max(FmiCaptureMaxMegabytes(), 0)) * 1024U * 1024U))
+  {
+    std::cerr << "Cannot write capture file " << FmiCaptureFile() << ", offending frames are not captured" << std::endl;
+  }
+}
+
+/* Queue the raw frame for the capture file if the rate limit of one of its missing fields allows it, the output counts the frames written so far */
+void OSIFieldChecker::CaptureFrame(bool capture, const void* buffer, int size)
 {
-  osi3::SensorData sensor_data_in;
-  osi3::SensorData sensor_data_out;
+  if (capture)
+  {
+    frame_capture_.Capture(buffer, static_cast<size_t>(size));
+  }
+  if (frame_capture_.IsOpen())
+  {
+    SetFmiCapturedFrameCount(static_cast<fmi2Integer>(min<uint64_t>(frame_capture_.GetStatistics().captured_frames, INT32_MAX)));
+  }
+}
 
-  const double start_check_in_s = 0.5;
+/* Resolve a file name relative to the resources directory of the FMU, absolute paths are kept */
+string OSIFieldChecker::ResourcePath(const string& file_name) const
+{
+  if (file_name.empty() || file_name[0] == '/' || (file_name.size() > 1 && file_name[1] == ':'))
+  {
+    return file_name;
+  }
+
+  string location = fmu_resource_location_;
+  const string file_scheme = "file:";
+  const bool is_uri = location.compare(0, file_scheme.size(), file_scheme) == 0;  // FMI 2.0 passes a URI, FMI 3.0 a native path
+  if (is_uri)
+  {
+    location.erase(0, file_scheme.size());
+    if (location.compare(0, 2, "//") == 0)
+    {
+      location.erase(0, location.find('/', 2));  // drop the (empty) authority
+    }
+#ifdef _WIN32
+    if (location.size() > 2 && location[0] == '/' && location[2] == ':')
+    {
+      location.erase(0, 1);
+    }
+#endif
+  }
 
-  if (GetFmiSensorDataIn(sensor_data_in) && current_communication_point > start_check_in_s)  // start checker after 0.5 s to give simulation models time to settle
+  string path;
+  for (size_t i = 0; i < location.size(); i++)
   {
-    if (!sensor_data_in.moving_object().empty() && expected_osi_fields_.find("moving_object") != expected_osi_fields_.end())
+    if (is_uri && location[i] == '%' && i + 2 < location.size())
     {
-      CheckMovingObjects(sensor_data_in, current_communication_point);
+      path += static_cast<char>(stoi(location.substr(i + 1, 2), nullptr, 16));
+      i += 2;
     }
     else
     {
-      if (expected_osi_fields_.find("moving_object") != expected_osi_fields_.end())
-      {
-        missing_fields_.insert("moving_object");
-        std::cout << current_communication_point << ": missing moving_object" << std::endl;
-      }
+      path += location[i];
     }
+  }
+  if (!path.empty() && path.back() != '/')
+  {
+    path += '/';
+  }
+  return path + file_name;
+}
 
-    /* Clear Output */
-    sensor_data_out.Clear();
-    sensor_data_out.CopyFrom(sensor_data_in);
+fmi2Status OSIFieldChecker::DoCalc(fmi2Real current_communication_point, fmi2Real communication_step_size)
+{
+  const chrono::steady_clock::time_point step_start = chrono::steady_clock::now();
+  const void* input_buffer = nullptr;
+  int input_size = 0;
+  bool valid_input = false;
+  parsed_input_bytes_ = 0;
 
-    /* Serialize */
-    SetFmiSensorDataOut(sensor_data_out);
-    SetFmiValid(1);
-    SetFmiCount(sensor_data_out.moving_object_size());
+  if (current_communication_point > FmiCheckStartTime())  // give simulation models time to settle
+  {
+    if (GetFmiSensorDataBatchInBuffer(input_buffer, input_size))
+    {
+      valid_input = CheckFrameBatch(input_buffer, input_size, current_communication_point, step_start);
+    }
+    else if (GetFmiSensorDataInBuffer(input_buffer, input_size))
+    {
+      CheckFrame(input_buffer, input_size, current_communication_point, false, step_start);
+      if (check_object_recall_ && last_frame_parsed_)
+      {
+        CheckObjectRecall(input_buffer, input_size, current_communication_point);
+      }
+      SetFmiSensorDataOutFromFrame(input_buffer, input_size);
+      valid_input = true;
+    }
   }
-  else
+
+  if (!valid_input)
   {
     /* We have no valid input, so no valid output */
-    NormalLog("OSI", "No valid input, therefore providing no valid output.");
+    NormalLog<kLogOsi>("No valid input, therefore providing no valid output.");
     ResetFmiSensorDataOut();
     SetFmiValid(0);
     SetFmiCount(0);
+    SetFmiCheckCoverage(0.0);
+  }
+
+  if (FmiStepTimeBudgetUs() > 0 && chrono::steady_clock::now() - step_start > chrono::microseconds(FmiStepTimeBudgetUs()))
+  {
+    SetFmiDeadlineMissCount(FmiDeadlineMissCount() + 1);
   }
   return fmi2OK;
 }
 
-void OSIFieldChecker::CheckMovingObjects(const osi3::SensorData& sensor_data_in, const fmi2Real& current_communication_point)
+/*
+ * Batched Input
+ *
+ * The batch buffer holds a sequence of SensorData frames, each preceded by
+ * its size as 32 bit little-endian integer (the layout of binary OSI trace
+ * files).  All frames are checked back to back in one step, with the
+ * timestamp of each frame used for its reports.
+ */
+bool OSIFieldChecker::CheckFrameBatch(const void* buffer, int size, const fmi2Real& current_communication_point, const chrono::steady_clock::time_point& step_start)
+{
+  const auto* position = static_cast<const unsigned char*>(buffer);
+  const unsigned char* const end = position + size;
+  const unsigned char* last_frame = nullptr;
+  uint32_t last_frame_size = 0;
+  while (end - position >= 4)
+  {
+    const uint32_t frame_size = uint32_t(position[0]) | (uint32_t(position[1]) << 8U) | (uint32_t(position[2]) << 16U) | (uint32_t(position[3]) << 24U);
+    position += 4;
+    if (frame_size > static_cast<uint32_t>(end - position))
+    {
+      NormalLog<kLogOsmp>("Truncated frame in batch input, %u bytes announced but only %d left.", frame_size, static_cast<int>(end - position));
+      break;
+    }
+    CheckFrame(position, static_cast<int>(frame_size), current_communication_point, true, step_start);
+    last_frame = position;
+    last_frame_size = frame_size;
+    position += frame_size;
+  }
+
+  /* The last complete frame of the batch is the output */
+  if (last_frame == nullptr)
+  {
+    return false;
+  }
+  SetFmiSensorDataOutFromFrame(last_frame, static_cast<int>(last_frame_size));
+  return true;
+}
+
+void OSIFieldChecker::CheckFrame(const void* buffer,
+                                 int size,
+                                 fmi2Real current_communication_point,
+                                 bool use_frame_timestamp,
+                                 const chrono::steady_clock::time_point& step_start)
+{
+  frames_received_++;
+  last_frame_parsed_ = false;
+  if (dynamic_field_checker_.IsLoaded())
+  {
+    /* Runtime-loaded descriptors, the input is checked by reflection */
+    frames_checked_++;
+    parsed_input_bytes_ += static_cast<size_t>(size);
+    CheckDynamicSensorData(buffer, size, current_communication_point);
+    SetFmiCount(dynamic_field_checker_.RepeatedFieldSize("moving_object"));
+    SetFmiCheckCoverage(1.0);
+  }
+  else if (sampling_active_ && (frames_received_ - 1) % static_cast<uint64_t>(max(FmiSampleFrameStride(), 1)) != 0)
+  {
+    /* Frame is skipped by sampling, it is not parsed at all */
+    SetFmiCheckCoverage(0.0);
+  }
+  else
+  {
+    sensor_data_in_.ParseFromArray(buffer, size);
+    last_frame_parsed_ = true;
+    parsed_input_bytes_ += static_cast<size_t>(size);
+    if (use_frame_timestamp && sensor_data_in_.has_timestamp())
+    {
+      current_communication_point = TimestampToSeconds(sensor_data_in_.timestamp());
+    }
+    frames_checked_++;
+    const FieldCheckMask missing = CheckSensorData(sensor_data_in_, current_communication_point, step_start);
+    UpdateSampling(missing, current_communication_point);
+    SetFmiCount(sensor_data_in_.moving_object_size());
+    if (missing != 0 && frame_capture_.IsOpen())
+    {
+      bool capture = false;
+      for (int i = 0; i < kFieldCheckCount; i++)
+      {
+        if ((missing & FieldCheckBit(static_cast<FieldCheck>(i))) != 0)
+        {
+          capture = frame_capture_.CountOccurrence(i) || capture;
+        }
+      }
+      CaptureFrame(capture, buffer, size);
+    }
+  }
+}
+
+void OSIFieldChecker::SetFmiSensorDataOutFromFrame(const void* buffer, int size)
+{
+  /* Reserialize parsed frames, forward all others unchanged */
+  if (last_frame_parsed_)
+  {
+    SetFmiSensorDataOut(sensor_data_in_);
+  }
+  else
+  {
+    SetFmiSensorDataOut(buffer, size);
+  }
+  SetFmiValid(1);
+}
+
+void OSIFieldChecker::CheckDynamicSensorData(const void* buffer, int size, const fmi2Real& current_communication_point)
+{
+  if (!dynamic_field_checker_.Check(buffer, size))
+  {
+    NormalLog<kLogOsi>("Input could not be parsed with the loaded descriptor set.");
+    return;
+  }
+  const auto& results = dynamic_field_checker_.GetResults();
+  FieldCounts counts;
+  bool capture = false;
+  for (size_t i = 0; i < results.size(); i++)
+  {
+    const int check = dynamic_field_checks_[i];
+    if (check >= 0)
+    {
+      counts.checked[check] += results[i].checked;
+      counts.missing[check] += results[i].missing;
+    }
+    if (results[i].missing > 0)
+    {
+      if (check < 0)
+      {
+        RecordMissingField(results[i].name);  // fields known to the generated checks are reported from the field statistics
+      }
+      std::cout << current_communication_point << ": missing " << results[i].name << " in " << results[i].missing << " of " << results[i].checked << std::endl;
+      capture = (frame_capture_.IsOpen() && frame_capture_.CountOccurrence(kCaptureDynamicFields + i)) || capture;
+    }
+  }
+  field_statistics_.Add(counts, enabled_checks_);
+  SetFmiFieldStatistics();
+  CaptureFrame(capture, buffer, size);
+}
+
+/*
+ * Adaptive Sampling
+ *
+ * The set of missing fields of a checked frame is its presence signature.
+ * Once the signature has not changed for sample_stable_frames checked
+ * frames, only every sample_frame_stride-th frame and every
+ * sample_object_stride-th object or detection chunk is checked.  Any change
+ * of the signature returns to full checking.
+ */
+void OSIFieldChecker::UpdateSampling(FieldCheckMask missing, const fmi2Real& current_communication_point)
+{
+  if (FmiSampleFrameStride() <= 1 && FmiSampleObjectStride() <= 1)
+  {
+    return;
+  }
+  if (missing != presence_signature_)
+  {
+    if (sampling_active_)
+    {
+      std::cout << current_communication_point << ": presence signature changed, returning to full checking" << std::endl;
+      /* Units of the current phase left unchecked by the step time budget stay next in line */
+      schedule_cursor_ = sample_phase_ + schedule_cursor_ * static_cast<size_t>(max(FmiSampleObjectStride(), 1));
+    }
+    presence_signature_ = missing;
+    stable_frames_ = 0;
+    sampling_active_ = false;
+    return;
+  }
+  stable_frames_++;
+  if (!sampling_active_ && stable_frames_ >= static_cast<uint64_t>(max(FmiSampleStableFrames(), 0)))
+  {
+    sampling_active_ = true;
+    const auto stride = static_cast<size_t>(max(FmiSampleObjectStride(), 1));
+    sample_phase_ = schedule_cursor_ % stride;
+    schedule_cursor_ /= stride;
+  }
+}
+
+FieldCheckMask OSIFieldChecker::CheckSensorData(const osi3::SensorData& sensor_data_in,
+                                                const fmi2Real& current_communication_point,
+                                                const chrono::steady_clock::time_point& step_start)
+{
+  FieldCounts counts;
+
+  /* Frame level checks always run completely */
+  FieldCheckMask missing = CheckFrameArrays(sensor_data_in, enabled_checks_, counts);
+  if (check_timestamp_monotonic_ || check_tracking_id_persistence_)
+  {
+    CheckTemporalConsistency(sensor_data_in, current_communication_point);
+  }
+
+  /* Object and detection checks are scheduled within the step time budget */
+  missing |= CheckScheduledUnits(sensor_data_in, step_start, counts);
+  ReportMissingFields(missing, counts, current_communication_point);
+  field_statistics_.Add(counts, enabled_checks_);
+  SetFmiFieldStatistics();
+  return missing;
+}
+
+void OSIFieldChecker::SetFmiFieldStatistics()
+{
+  const auto saturate = [](uint64_t value) { return static_cast<fmi2Integer>(min<uint64_t>(value, INT32_MAX)); };
+  for (int i = 0; i < kFieldCheckCount; i++)
+  {
+    integer_vars_[FMI_INTEGER_FIELD_CHECKED_OFFSET + i] = saturate(field_statistics_.checked[i]);
+    integer_vars_[FMI_INTEGER_FIELD_MISSING_OFFSET + i] = saturate(field_statistics_.missing[i]);
+    integer_vars_[FMI_INTEGER_FIELD_MISSING_FRAMES_OFFSET + i] = saturate(field_statistics_.frames_missing[i]);
+    real_vars_[FMI_REAL_FIELD_FILL_RATE_OFFSET + i] = field_statistics_.FillRate(static_cast<FieldCheck>(i));
+  }
+}
+
+void OSIFieldChecker::BuildSchedule(const osi3::SensorData& sensor_data_in)
+{
+  schedule_.clear();
+  size_t units = 0;
+  if ((enabled_checks_ & FieldCheckBit(kCheckMovingObject)) != 0 && (enabled_checks_ & kMovingObjectChecks) != 0 && !sensor_data_in.moving_object().empty())
+  {
+    schedule_.push_back({kScheduleMovingObjects, 0, units, static_cast<size_t>(sensor_data_in.moving_object_size())});
+    units += schedule_.back().unit_count;
+  }
+  if ((enabled_checks_ & kLidarChecks) != 0)
+  {
+    for (int i = 0; i < sensor_data_in.feature_data().lidar_sensor_size(); i++)
+    {
+      const auto detections = static_cast<size_t>(sensor_data_in.feature_data().lidar_sensor(i).detection_size());
+      schedule_.push_back({kScheduleLidarDetections, i, units, (detections + kDetectionChunkSize - 1) / kDetectionChunkSize});
+      units += schedule_.back().unit_count;
+    }
+  }
+  if ((enabled_checks_ & kRadarChecks) != 0)
+  {
+    for (int i = 0; i < sensor_data_in.feature_data().radar_sensor_size(); i++)
+    {
+      const auto detections = static_cast<size_t>(sensor_data_in.feature_data().radar_sensor(i).detection_size());
+      schedule_.push_back({kScheduleRadarDetections, i, units, (detections + kDetectionChunkSize - 1) / kDetectionChunkSize});
+      units += schedule_.back().unit_count;
+    }
+  }
+}
+
+FieldCheckMask OSIFieldChecker::CheckScheduledUnit(const osi3::SensorData& sensor_data_in, size_t unit, FieldCounts& counts)
+{
+  const ScheduleSegment* segment = &schedule_.front();
+  while (unit >= segment->first_unit + segment->unit_count)
+  {
+    segment++;
+  }
+  const size_t index = unit - segment->first_unit;
+  switch (segment->kind)
+  {
+    case kScheduleMovingObjects: {
+      const osi3::DetectedMovingObject& moving_object = sensor_data_in.moving_object(static_cast<int>(index));
+      const FieldCheckMask missing = CheckMovingObject(moving_object, enabled_checks_, counts);
+      if (missing_field_map_.IsEnabled())
+      {
+        missing_field_map_.Add(moving_object, missing != 0);
+      }
+      return missing;
+    }
+    case kScheduleLidarDetections: {
+      const osi3::LidarDetectionData& lidar_sensor = sensor_data_in.feature_data().lidar_sensor(segment->sensor);
+      const auto begin = static_cast<int>(index * kDetectionChunkSize);
+      return CheckLidarDetections(lidar_sensor, begin, min(begin + static_cast<int>(kDetectionChunkSize), lidar_sensor.detection_size()), enabled_checks_, counts);
+    }
+    case kScheduleRadarDetections: {
+      const osi3::RadarDetectionData& radar_sensor = sensor_data_in.feature_data().radar_sensor(segment->sensor);
+      const auto begin = static_cast<int>(index * kDetectionChunkSize);
+      return CheckRadarDetections(radar_sensor, begin, min(begin + static_cast<int>(kDetectionChunkSize), radar_sensor.detection_size()), enabled_checks_, counts);
+    }
+  }
+  return 0;
+}
+
+FieldCheckMask OSIFieldChecker::CheckScheduledUnits(const osi3::SensorData& sensor_data_in, const chrono::steady_clock::time_point& step_start, FieldCounts& counts)
 {
-  for (const auto& current_check : expected_osi_fields_)
+  BuildSchedule(sensor_data_in);
+  const size_t units = schedule_.empty() ? 0 : schedule_.back().first_unit + schedule_.back().unit_count;
+  if (units == 0)
   {
-    if (current_check == "moving_object.base" && !sensor_data_in.moving_object(0).has_base())
+    SetFmiCheckCoverage(1.0);
+    return 0;
+  }
+
+  /*
+   * Without a budget every unit is checked.  With a budget, checking starts
+   * at the unit where the previous step ran out of time, so units left
+   * unchecked are carried forward to the following frames.  While sampling,
+   * every stride-th unit is checked, starting at a phase that rotates from
+   * frame to frame.  schedule_cursor_ then counts the units of the current
+   * phase, which only rotates once all of its units were checked.
+   */
+  const bool budgeted = FmiStepTimeBudgetUs() > 0;
+  const chrono::steady_clock::time_point deadline = step_start + chrono::microseconds(max(FmiStepTimeBudgetUs(), 0));
+  const size_t stride = sampling_active_ ? static_cast<size_t>(max(FmiSampleObjectStride(), 1)) : 1;
+  size_t first_unit = 0;
+  size_t phase_units = units;
+  if (stride > 1)
+  {
+    first_unit = sample_phase_ % stride;
+    phase_units = first_unit < units ? (units - first_unit + stride - 1) / stride : 0;
+  }
+  size_t position = (budgeted && phase_units > 0) ? schedule_cursor_ % phase_units : 0;
+  const size_t scheduled_units = (stride > 1) ? phase_units - position : phase_units;
+  size_t checked_units = 0;
+  FieldCheckMask missing = 0;
+  while (checked_units < scheduled_units)
+  {
+    if (budgeted && chrono::steady_clock::now() >= deadline)
     {
-      missing_fields_.insert(current_check);
-      std::cout << current_communication_point << ": missing " << current_check << std::endl;
+      break;
     }
-    else if (current_check == "moving_object.base.dimension" && sensor_data_in.moving_object(0).has_base() && !sensor_data_in.moving_object(0).base().has_dimension())
+    missing |= CheckScheduledUnit(sensor_data_in, first_unit + position * stride, counts);
+    checked_units++;
+    position = (position + 1 < phase_units) ? position + 1 : 0;
+  }
+  if (stride > 1 && checked_units == scheduled_units)
+  {
+    sample_phase_ = (sample_phase_ + 1) % stride;
+    position = 0;
+  }
+  schedule_cursor_ = position;
+  units_scheduled_ += units;
+  units_checked_ += checked_units;
+  SetFmiCheckCoverage(static_cast<fmi2Real>(checked_units) / static_cast<fmi2Real>(units));
+  return missing;
+}
+
+void OSIFieldChecker::ReportMissingFields(FieldCheckMask missing, const FieldCounts& counts, const fmi2Real& current_communication_point)
+{
+  for (int i = 0; i < kFieldCheckCount; i++)
+  {
+    if ((missing & FieldCheckBit(static_cast<FieldCheck>(i))) == 0)
     {
-      missing_fields_.insert(current_check);
-      std::cout << current_communication_point << ": missing " << current_check << std::endl;
+      continue;
     }
-    else if (current_check == "moving_object.base.position" && sensor_data_in.moving_object(0).has_base() && !sensor_data_in.moving_object(0).base().has_position())
+    if (i == kCheckMovingObject || i == kCheckLidarDetection || i == kCheckRadarDetection)
     {
-      missing_fields_.insert(current_check);
-      std::cout << current_communication_point << ": missing " << current_check << std::endl;
+      std::cout << current_communication_point << ": missing " << kFieldCheckNames[i] << std::endl;
     }
-    else if (current_check == "moving_object.base.orientation" && sensor_data_in.moving_object(0).has_base() && !sensor_data_in.moving_object(0).base().has_orientation())
+    else
     {
-      missing_fields_.insert(current_check);
-      std::cout << current_communication_point << ": missing " << current_check << std::endl;
+      std::cout << current_communication_point << ": missing " << kFieldCheckNames[i] << " in " << counts.missing[i] << " of " << counts.checked[i] << " "
+                << FieldCheckUnit(static_cast<FieldCheck>(i)) << std::endl;
     }
-    else if (current_check == "moving_object.base.velocity" && sensor_data_in.moving_object(0).has_base() && !sensor_data_in.moving_object(0).base().has_velocity())
+  }
+}
+
+void OSIFieldChecker::CheckTemporalConsistency(const osi3::SensorData& sensor_data_in, const fmi2Real& current_communication_point)
+{
+  /* Frames without timestamp still count for the tracking ids */
+  if (!sensor_data_in.has_timestamp())
+  {
+    temporal_checker_.BeginFrame();
+    if (check_timestamp_monotonic_)
     {
-      missing_fields_.insert(current_check);
-      std::cout << current_communication_point << ": missing " << current_check << std::endl;
+      RecordMissingField("timestamp");
+      std::cout << current_communication_point << ": missing timestamp" << std::endl;
     }
-    else if (current_check == "moving_object.base.acceleration" && sensor_data_in.moving_object(0).has_base() && !sensor_data_in.moving_object(0).base().has_acceleration())
+  }
+  else
+  {
+    const double timestamp = TimestampToSeconds(sensor_data_in.timestamp());
+    const double last_timestamp = temporal_checker_.LastTimestamp();
+    if (!temporal_checker_.BeginFrame(timestamp) && check_timestamp_monotonic_)
     {
-      missing_fields_.insert(current_check);
-      std::cout << current_communication_point << ": missing " << current_check << std::endl;
+      std::cout << current_communication_point << ": non-monotonic timestamp " << timestamp << " after " << last_timestamp << std::endl;
     }
-    else if (current_check == "moving_object.base.orientation_rate" && sensor_data_in.moving_object(0).has_base() && !sensor_data_in.moving_object(0).base().has_orientation_rate())
+  }
+
+  if (!check_tracking_id_persistence_)
+  {
+    return;
+  }
+  for (const auto& moving_object : sensor_data_in.moving_object())
+  {
+    if (!moving_object.header().has_tracking_id())
     {
-      missing_fields_.insert(current_check);
-      std::cout << current_communication_point << ": missing " << current_check << std::endl;
+      RecordMissingField("moving_object.header.tracking_id");
+      std::cout << current_communication_point << ": missing moving_object.header.tracking_id" << std::endl;
+      continue;
     }
-    else if (current_check == "moving_object.base.orientation_acceleration" && sensor_data_in.moving_object(0).has_base() &&
-             !sensor_data_in.moving_object(0).base().has_orientation_acceleration())
+    const uint64_t tracking_id = moving_object.header().tracking_id().value();
+    const bool has_ground_truth_id = moving_object.header().ground_truth_id_size() > 0;
+    const uint64_t ground_truth_id = has_ground_truth_id ? moving_object.header().ground_truth_id(0).value() : 0;
+    uint64_t previous_tracking_id = 0;
+    uint64_t absent_frames = 0;
+    switch (temporal_checker_.UpdateObject(tracking_id, has_ground_truth_id ? &ground_truth_id : nullptr, previous_tracking_id, absent_frames))
     {
-      missing_fields_.insert(current_check);
-      std::cout << current_communication_point << ": missing " << current_check << std::endl;
+      case TemporalConsistencyChecker::kObjectDuplicate:
+        std::cout << current_communication_point << ": duplicate tracking_id " << tracking_id << std::endl;
+        break;
+      case TemporalConsistencyChecker::kObjectIdChanged:
+        std::cout << current_communication_point << ": tracking_id of ground truth id " << ground_truth_id << " changed from " << previous_tracking_id << " to "
+                  << tracking_id << std::endl;
+        break;
+      default:
+        break;
     }
-    else if (current_check == "moving_object.base.base_polygon" && sensor_data_in.moving_object(0).has_base() && sensor_data_in.moving_object(0).base().base_polygon().empty())
+    if (absent_frames > 0)
     {
-      missing_fields_.insert(current_check);
-      std::cout << current_communication_point << ": missing " << current_check << std::endl;
+      std::cout << current_communication_point << ": tracking_id " << tracking_id << " reappeared after " << absent_frames << " absent frames" << std::endl;
     }
   }
+  temporal_checker_.EndFrame();
+}
+
+/* Every ground truth object in the region covered by the sensor has to be detected in the SensorData of the same step */
+void OSIFieldChecker::CheckObjectRecall(const void* buffer, int size, const fmi2Real& current_communication_point)
+{
+  const void* sensor_view_buffer = nullptr;
+  int sensor_view_size = 0;
+  if (!GetFmiSensorViewInBuffer(sensor_view_buffer, sensor_view_size) || !sensor_view_in_.ParseFromArray(sensor_view_buffer, sensor_view_size))
+  {
+    NormalLog<kLogOsi>("No valid SensorView input, object recall not checked.");
+    return;
+  }
+  parsed_input_bytes_ += static_cast<size_t>(sensor_view_size);
+  RecallRegion region;
+  region.range = FmiNominalRange();
+  region.fov_horizontal = FmiRecallFovHorizontal();
+  region.fov_vertical = FmiRecallFovVertical();
+  object_recall_checker_.Check(sensor_view_in_, sensor_data_in_, region);
+  SetFmiObjectRecall(object_recall_checker_.Recall());
+  SetFmiMissedObjectCount(static_cast<fmi2Integer>(object_recall_checker_.MissedIds().size()));
+
+  const std::vector<uint64_t>& missed_ids = object_recall_checker_.MissedIds();
+  if (missed_ids.empty())
+  {
+    return;
+  }
+  const size_t kMaxReportedIds = 10;
+  std::cout << current_communication_point << ": missed " << missed_ids.size() << " of " << object_recall_checker_.InRange() << " moving objects in range, ground truth ids";
+  for (size_t i = 0; i < missed_ids.size() && i < kMaxReportedIds; i++)
+  {
+    std::cout << " " << missed_ids[i];
+  }
+  std::cout << (missed_ids.size() > kMaxReportedIds ? " ..." : "") << std::endl;
+  if (frame_capture_.IsOpen())
+  {
+    CaptureFrame(frame_capture_.CountOccurrence(kCaptureMissedObjects), buffer, size);
+  }
+}
+
+/* Names of fields missing in the reflection and temporal checks, limited to max_missing_field_names */
+void OSIFieldChecker::RecordMissingField(const string& field_name)
+{
+  if (missing_fields_.size() >= static_cast<size_t>(max(FmiMaxMissingFieldNames(), 0)) && missing_fields_.count(field_name) == 0)
+  {
+    missing_fields_dropped_++;
+    return;
+  }
+  if (missing_fields_.insert(field_name).second)
+  {
+    missing_fields_bytes_ += sizeof(string) + 4 * sizeof(void*) + field_name.size() + 1;  // tree node and name
+  }
+}
+
+/*
+ * Memory Budget
+ *
+ * The memory of an instance is estimated from the capacity of its buffers
+ * after every step; the check profile and descriptors shared by all
+ * instances of the process are not included.  With memory_budget_megabytes
+ * set, the idle half of the output double buffer is shrunk once it is more
+ * than twice the size of the published frame, and if the estimate still
+ * exceeds the budget, every buffer that is only reused between frames is
+ * released and allocated again by the next frame.
+ */
+size_t OSIFieldChecker::MemoryUsage()
+{
+  if (parsed_input_bytes_ > measured_input_bytes_)
+  {
+    measured_input_bytes_ = parsed_input_bytes_;
+    parsed_memory_bytes_ = sensor_data_in_.SpaceUsedLong() - sizeof(sensor_data_in_) + sensor_view_in_.SpaceUsedLong() - sizeof(sensor_view_in_) +
+                           dynamic_field_checker_.MessageMemoryUsage();
+  }
+  size_t bytes = sizeof(OSIFieldChecker) + parsed_memory_bytes_ + missing_fields_bytes_;
+  bytes += 2 * sizeof(string) + current_output_buffer_->capacity() + last_output_buffer_->capacity();
+  bytes += schedule_.capacity() * sizeof(ScheduleSegment);
+  bytes += temporal_checker_.MemoryUsage() + frame_capture_.MemoryUsage() + object_recall_checker_.MemoryUsage() + missing_field_map_.MemoryUsage();
+  bytes += VariantMemoryUsage();
+#if defined(PRIVATE_LOG_PATH) || defined(PUBLIC_LOGGING)
+  bytes += logger_->MemoryUsage();
+#endif
+  return bytes;
+}
+
+bool OSIFieldChecker::OverMemoryBudget(size_t bytes)
+{
+  return FmiMemoryBudgetMegabytes() > 0 && bytes > static_cast<size_t>(FmiMemoryBudgetMegabytes()) * 1024U * 1024U;
+}
+
+void OSIFieldChecker::ShrinkBuffers(bool release_all)
+{
+  /* The published frame has to stay valid until the next step, only the idle buffer is shrunk */
+  if (current_output_buffer_->capacity() > 2 * last_output_buffer_->size())
+  {
+    string().swap(*current_output_buffer_);
+  }
+  if (!release_all)
+  {
+    return;
+  }
+  osi3::SensorData().Swap(&sensor_data_in_);
+  osi3::SensorView().Swap(&sensor_view_in_);
+  dynamic_field_checker_.ReleaseMessage();
+  object_recall_checker_.Release();
+  frame_capture_.ReleaseIdleSlots();
+  std::vector<ScheduleSegment>().swap(schedule_);
+  ReleaseVariantBuffers();
+  measured_input_bytes_ = 0;
+  parsed_memory_bytes_ = 0;
+}
+
+/* Peak is the usage before buffers were released, the budget counts as exceeded if they were not enough */
+void OSIFieldChecker::RecordMemoryUsage(size_t peak_bytes, size_t current_bytes)
+{
+  memory_peak_bytes_ = max(memory_peak_bytes_, peak_bytes);
+  if (OverMemoryBudget(current_bytes))
+  {
+    memory_budget_overruns_++;
+  }
+  SetFmiMemoryCurrentKilobytes(static_cast<fmi2Integer>(min<size_t>(current_bytes / 1024U, INT32_MAX)));
+  SetFmiMemoryPeakKilobytes(static_cast<fmi2Integer>(min<size_t>(memory_peak_bytes_ / 1024U, INT32_MAX)));
+}
+
+void OSIFieldChecker::EnforceMemoryBudget()
+{
+  const size_t usage = MemoryUsage();
+  size_t current = usage;
+  if (FmiMemoryBudgetMegabytes() > 0)
+  {
+    ShrinkBuffers(OverMemoryBudget(usage));
+    current = MemoryUsage();
+  }
+  RecordMemoryUsage(usage, current);
 }
 
 fmi2Status OSIFieldChecker::DoTerm()
@@ -323,10 +1049,38 @@ OSIFieldChecker::OSIFieldChecker(fmi2String theinstance_name,
       current_output_buffer_(new string()),
       last_output_buffer_(new string())
 {
-  logging_categories_.clear();
-  logging_categories_.insert("FMI");
-  logging_categories_.insert("OSMP");
-  logging_categories_.insert("OSI");
+  DoInit();
+  logging_categories_ = kLogFmi | kLogOsmp | kLogOsi;
+#if defined(PRIVATE_LOG_PATH) || defined(PUBLIC_LOGGING)
+  logger_.reset(new AsyncLogger([this](LogCategory category, uint32_t sinks, const char* message) { WriteLog(category, sinks, message); }));
+#endif
+}
+
+void OSIFieldChecker::WriteLog(LogCategory category, uint32_t sinks, const char* message)
+{
+#ifdef PRIVATE_LOG_PATH
+  {
+    std::lock_guard<std::mutex> lock(private_log_mutex);
+    if (!private_log_file.is_open())
+      private_log_file.open(PRIVATE_LOG_PATH, ios::out | ios::app);
+    if (private_log_file.is_open())
+    {
+      if (message == nullptr)
+      {
+        private_log_file.flush();  // flushed once the queue is empty instead of after every message
+      }
+      else if ((sinks & kLogSinkPrivateFile) != 0)
+      {
+        private_log_file << "OSIFieldChecker"
+                         << "::" << instance_name_ << "<" << ((void*)this) << ">:" << LogCategoryName(category) << ": " << message << "\n";
+      }
+    }
+  }
+#endif
+#ifdef PUBLIC_LOGGING
+  if (message != nullptr && (sinks & kLogSinkFmiLogger) != 0)
+    functions_.logger(functions_.componentEnvironment, instance_name_.c_str(), fmi2OK, LogCategoryName(category), message);
+#endif
 }
 
 fmi2Status OSIFieldChecker::SetDebugLogging(fmi2Boolean thelogging_on, size_t n_categories, const fmi2String categories[])
@@ -335,29 +1089,26 @@ fmi2Status OSIFieldChecker::SetDebugLogging(fmi2Boolean thelogging_on, size_t n_
   logging_on_ = thelogging_on != 0;
   if ((categories != nullptr) && (n_categories > 0))
   {
-    logging_categories_.clear();
+    logging_categories_ = 0;
     for (size_t i = 0; i < n_categories; i++)
     {
       if (0 == strcmp(categories[i], "FMI"))
       {
-        logging_categories_.insert("FMI");
+        logging_categories_ |= kLogFmi;
       }
       else if (0 == strcmp(categories[i], "OSMP"))
       {
-        logging_categories_.insert("OSMP");
+        logging_categories_ |= kLogOsmp;
       }
       else if (0 == strcmp(categories[i], "OSI"))
       {
-        logging_categories_.insert("OSI");
+        logging_categories_ |= kLogOsi;
       }
     }
   }
   else
   {
-    logging_categories_.clear();
-    logging_categories_.insert("FMI");
-    logging_categories_.insert("OSMP");
-    logging_categories_.insert("OSI");
+    logging_categories_ = kLogFmi | kLogOsmp | kLogOsi;
   }
   return fmi2OK;
 }
@@ -400,7 +1151,9 @@ fmi2Status OSIFieldChecker::ExitInitializationMode()
 fmi2Status OSIFieldChecker::DoStep(fmi2Real current_communication_point, fmi2Real communication_step_size, fmi2Boolean no_set_fmu_state_prior_to_current_pointfmi2_component)
 {
   FmiVerboseLog("fmi2DoStep(%g,%g,%d)", current_communication_point, communication_step_size, no_set_fmu_state_prior_to_current_pointfmi2_component);
-  return DoCalc(current_communication_point, communication_step_size);
+  const fmi2Status status = DoCalc(current_communication_point, communication_step_size);
+  EnforceMemoryBudget();
+  return status;
 }
 
 fmi2Status OSIFieldChecker::Terminate()
@@ -409,14 +1162,115 @@ fmi2Status OSIFieldChecker::Terminate()
 
   int num_missing_fields = 0;
 
-  if (!missing_fields_.empty())
+  /* Fields with a fill rate of at least min_fill_rate are only reported as warning */
+  const FieldReport field_report = ReportFieldStatistics(field_statistics_, FmiMinFillRate());
+  for (const auto& line : field_report.lines)
+  {
+    std::cout << line << std::endl;
+  }
+  num_missing_fields += field_report.failed ? 1 : 0;
+
+  /* Fields checked by reflection and by the temporal checks */
+  for (const auto& current_missing_field : missing_fields_)
+  {
+    std::cout << "::error title=MissingField::" << current_missing_field << std::endl;
+    num_missing_fields++;
+  }
+  if (missing_fields_dropped_ > 0)
+  {
+    std::cout << "::error title=MissingField::further missing fields not recorded " << missing_fields_dropped_ << " times, consider raising max_missing_field_names"
+              << std::endl;
+    num_missing_fields++;
+  }
+
+  const TemporalConsistencyChecker::Statistics& temporal_statistics = temporal_checker_.GetStatistics();
+  if (check_timestamp_monotonic_ && temporal_statistics.timestamp_violations > 0)
+  {
+    std::cout << "::error title=TemporalConsistency::non-monotonic timestamp in " << temporal_statistics.timestamp_violations << " frames" << std::endl;
+    num_missing_fields++;
+  }
+  if (check_tracking_id_persistence_ && temporal_statistics.duplicate_ids > 0)
+  {
+    std::cout << "::error title=TemporalConsistency::duplicate tracking_id " << temporal_statistics.duplicate_ids << " times" << std::endl;
+    num_missing_fields++;
+  }
+  if (check_tracking_id_persistence_ && temporal_statistics.gap_violations > 0)
+  {
+    std::cout << "::error title=TemporalConsistency::tracking_id reappeared after more than " << temporal_checker_.MaxAbsentFrames() << " absent frames "
+              << temporal_statistics.gap_violations << " times" << std::endl;
+    num_missing_fields++;
+  }
+  if (check_tracking_id_persistence_ && temporal_statistics.id_changes > 0)
+  {
+    std::cout << "::error title=TemporalConsistency::tracking_id of the same ground truth object changed " << temporal_statistics.id_changes << " times" << std::endl;
+    num_missing_fields++;
+  }
+  if (check_tracking_id_persistence_ && temporal_statistics.evictions > 0)
+  {
+    std::cout << "::warning title=TemporalConsistency::" << temporal_statistics.evictions << " tracking ids evicted, consider raising temporal_max_tracked_ids"
+              << std::endl;
+  }
+
+  const ObjectRecallChecker::Statistics& recall_statistics = object_recall_checker_.GetStatistics();
+  if (check_object_recall_ && recall_statistics.objects_matched < recall_statistics.objects_in_range)
+  {
+    std::cout << "::error title=MissedObjects::" << DescribeObjectRecall(object_recall_checker_) << std::endl;
+    num_missing_fields++;
+  }
+
+  if (FmiSampleFrameStride() > 1 || FmiSampleObjectStride() > 1)
+  {
+    std::cout << "::notice title=SamplingCoverage::checked " << frames_checked_ << " of " << frames_received_ << " frames and " << units_checked_ << " of "
+              << units_scheduled_ << " objects or detection chunks in checked frames" << std::endl;
+  }
+
+  if (memory_budget_overruns_ > 0)
+  {
+    std::cout << "::warning title=MemoryBudget::memory_budget_megabytes exceeded after releasing buffers in " << memory_budget_overruns_ << " steps, peak "
+              << memory_peak_bytes_ / 1024U << " kB" << std::endl;
+  }
+
+  if (missing_field_map_.IsEnabled())
   {
-    for (const auto& current_missing_field : missing_fields_)
+    if (missing_field_map_.WriteCsv(FmiMissingMapFile()))
     {
-      std::cout << "::error title=MissingField::" << current_missing_field << std::endl;
-      num_missing_fields++;
+      std::cout << "::notice title=MissingFieldMap::" << missing_field_map_.MissingObjects() << " moving objects with missing fields mapped to " << FmiMissingMapFile();
+      if (missing_field_map_.UnplacedObjects() > 0)
+      {
+        std::cout << ", " << missing_field_map_.UnplacedObjects() << " objects without valid position not mapped";
+      }
+      std::cout << std::endl;
+    }
+    else
+    {
+      std::cerr << "Cannot write missing field map " << FmiMissingMapFile() << std::endl;
+    }
+  }
+
+  if (frame_capture_.IsOpen())
+  {
+    frame_capture_.Close();
+    const FrameCapture::Statistics capture_statistics = frame_capture_.GetStatistics();
+    SetFmiCapturedFrameCount(static_cast<fmi2Integer>(min<uint64_t>(capture_statistics.captured_frames, INT32_MAX)));
+    std::cout << "::notice title=FrameCapture::" << capture_statistics.captured_frames << " offending frames written to " << frame_capture_.Path() << std::endl;
+    if (capture_statistics.dropped_queue_full > 0 || capture_statistics.dropped_size_limit > 0)
+    {
+      std::cout << "::warning title=FrameCapture::" << capture_statistics.dropped_queue_full << " frames dropped because the writer was busy, "
+                << capture_statistics.dropped_size_limit << " because capture_max_megabytes was reached" << std::endl;
+    }
+    if (capture_statistics.dropped_write_error > 0)
+    {
+      std::cout << "::error title=FrameCapture::" << capture_statistics.dropped_write_error << " frames lost because writing " << frame_capture_.Path() << " failed" << std::endl;
     }
   }
+
+#if defined(PRIVATE_LOG_PATH) || defined(PUBLIC_LOGGING)
+  if (logger_->Dropped() > 0)
+  {
+    std::cout << "::warning title=Logging::" << logger_->Dropped() << " log messages dropped because the log buffer was full" << std::endl;
+  }
+#endif
+
   if (num_missing_fields > 0)
   {
     std::cout << "test failed" << std::endl;
@@ -424,6 +1278,9 @@ fmi2Status OSIFieldChecker::Terminate()
     system(output.c_str());
   }
 
+#if defined(PRIVATE_LOG_PATH) || defined(PUBLIC_LOGGING)
+  logger_->Flush();
+#endif
   return DoTerm();
 }
 
@@ -431,9 +1288,47 @@ fmi2Status OSIFieldChecker::Reset()
 {
   FmiVerboseLog("fmi2Reset()");
 
-  // DoFree();
+  /*
+   * Fast reset for running many scenarios with one instance: parameters,
+   * the loaded check profile and all buffers are kept, only the results of
+   * the previous run are cleared.
+   */
   simulation_started_ = false;
-  return DoInit();
+  ResetRunState();
+  return fmi2OK;
+}
+
+void OSIFieldChecker::ResetRunState()
+{
+  missing_fields_.clear();
+  missing_fields_bytes_ = 0;
+  missing_fields_dropped_ = 0;
+  memory_budget_overruns_ = 0;  // peak memory is kept, it belongs to the instance rather than the run
+  field_statistics_ = FieldStatistics();
+  SetFmiFieldStatistics();
+  temporal_checker_.Reset();
+  schedule_cursor_ = 0;
+  sampling_active_ = false;
+  presence_signature_ = 0;
+  stable_frames_ = 0;
+  sample_phase_ = 0;
+  frames_received_ = 0;
+  frames_checked_ = 0;
+  units_scheduled_ = 0;
+  units_checked_ = 0;
+  last_frame_parsed_ = false;
+  frame_capture_.Close();
+  SetFmiCapturedFrameCount(0);
+  object_recall_checker_.Reset();
+  missing_field_map_.Reset();
+  SetFmiObjectRecall(1.0);
+  SetFmiMissedObjectCount(0);
+
+  ResetFmiSensorDataOut();
+  SetFmiValid(0);
+  SetFmiCount(0);
+  SetFmiCheckCoverage(1.0);
+  SetFmiDeadlineMissCount(0);
 }
 
 void OSIFieldChecker::FreeInstance()
@@ -583,9 +1478,10 @@ fmi2Status OSIFieldChecker::SetString(const fmi2ValueReference vr[], size_t nvr,
 }
 
 /*
- * FMI 2.0 Co-Simulation Interface API
+ * FMI 2.0 Co-Simulation Interface API, the FMI 3.0 variant exports its own (see OSIFieldCheckerFmi3.cpp)
  */
 
+#ifndef BUILD_FMI3
 extern "C" {
 
 FMI2_Export const char* fmi2GetTypesPlatform()
@@ -799,3 +1695,4 @@ FMI2_Export fmi2Status fmi2GetStringStatus(fmi2Component c, const fmi2StatusKind
   return fmi2Discard;
 }
 }
+#endif  // BUILD_FMI3
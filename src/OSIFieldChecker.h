@@ -54,32 +54,93 @@
 //#define FMI_INTEGER_SENSORVIEW_CONFIG_BASEHI_IDX 10
 //#define FMI_INTEGER_SENSORVIEW_CONFIG_SIZE_IDX 11
 #define FMI_INTEGER_COUNT_IDX 12
-#define FMI_INTEGER_LAST_IDX FMI_INTEGER_COUNT_IDX
+#define FMI_INTEGER_TEMPORAL_MAX_TRACKED_IDS_IDX 13
+#define FMI_INTEGER_TEMPORAL_MAX_ABSENT_FRAMES_IDX 14
+#define FMI_INTEGER_STEP_TIME_BUDGET_US_IDX 15
+#define FMI_INTEGER_DEADLINE_MISS_COUNT_IDX 16
+#define FMI_INTEGER_SAMPLE_FRAME_STRIDE_IDX 17
+#define FMI_INTEGER_SAMPLE_OBJECT_STRIDE_IDX 18
+#define FMI_INTEGER_SAMPLE_STABLE_FRAMES_IDX 19
+#define FMI_INTEGER_SENSORDATA_BATCH_IN_BASELO_IDX 20
+#define FMI_INTEGER_SENSORDATA_BATCH_IN_BASEHI_IDX 21
+#define FMI_INTEGER_SENSORDATA_BATCH_IN_SIZE_IDX 22
+#define FMI_INTEGER_FIELD_CHECKED_OFFSET 23
+#define FMI_INTEGER_FIELD_CHECKED_SIZE 18
+#define FMI_INTEGER_FIELD_MISSING_OFFSET 41
+#define FMI_INTEGER_FIELD_MISSING_SIZE 18
+#define FMI_INTEGER_FIELD_MISSING_FRAMES_OFFSET 59
+#define FMI_INTEGER_FIELD_MISSING_FRAMES_SIZE 18
+#define FMI_INTEGER_CAPTURE_FIRST_OCCURRENCES_IDX 77
+#define FMI_INTEGER_CAPTURE_OCCURRENCE_STRIDE_IDX 78
+#define FMI_INTEGER_CAPTURE_MAX_MEGABYTES_IDX 79
+#define FMI_INTEGER_CAPTURED_FRAME_COUNT_IDX 80
+#define FMI_INTEGER_SENSORVIEW_IN_BASELO_IDX 81
+#define FMI_INTEGER_SENSORVIEW_IN_BASEHI_IDX 82
+#define FMI_INTEGER_SENSORVIEW_IN_SIZE_IDX 83
+#define FMI_INTEGER_MISSED_OBJECT_COUNT_IDX 84
+#define FMI_INTEGER_MEMORY_BUDGET_MEGABYTES_IDX 85
+#define FMI_INTEGER_MAX_MISSING_FIELD_NAMES_IDX 86
+#define FMI_INTEGER_MEMORY_CURRENT_KILOBYTES_IDX 87
+#define FMI_INTEGER_MEMORY_PEAK_KILOBYTES_IDX 88
+#define FMI_INTEGER_MISSING_MAP_RANGE_BINS_IDX 89
+#define FMI_INTEGER_MISSING_MAP_AZIMUTH_BINS_IDX 90
+#define FMI_INTEGER_LAST_IDX FMI_INTEGER_MISSING_MAP_AZIMUTH_BINS_IDX
 #define FMI_INTEGER_VARS (FMI_INTEGER_LAST_IDX + 1)
 
 /* Real Variables */
 #define FMI_REAL_NOMINAL_RANGE_IDX 0
-#define FMI_REAL_LAST_IDX FMI_REAL_NOMINAL_RANGE_IDX
+#define FMI_REAL_CHECK_COVERAGE_IDX 1
+#define FMI_REAL_CHECK_START_TIME_IDX 2
+#define FMI_REAL_MIN_FILL_RATE_IDX 3
+#define FMI_REAL_FIELD_FILL_RATE_OFFSET 4
+#define FMI_REAL_FIELD_FILL_RATE_SIZE 18
+#define FMI_REAL_OBJECT_RECALL_IDX 22
+#define FMI_REAL_RECALL_FOV_HORIZONTAL_IDX 23
+#define FMI_REAL_RECALL_FOV_VERTICAL_IDX 24
+#define FMI_REAL_LAST_IDX FMI_REAL_RECALL_FOV_VERTICAL_IDX
 #define FMI_REAL_VARS (FMI_REAL_LAST_IDX + 1)
 
 /* String Variables */
 #define FMI_STRING_CHECK_FILE_IDX 0
-#define FMI_STRING_LAST_IDX FMI_STRING_CHECK_FILE_IDX
+#define FMI_STRING_DESCRIPTOR_SET_IDX 1
+#define FMI_STRING_CAPTURE_FILE_IDX 2
+#define FMI_STRING_MISSING_MAP_FILE_IDX 3
+#define FMI_STRING_LAST_IDX FMI_STRING_MISSING_MAP_FILE_IDX
 #define FMI_STRING_VARS (FMI_STRING_LAST_IDX + 1)
 
+#include <chrono>
 #include <cstdarg>
 #include <fstream>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <set>
 #include <string>
+#include <vector>
 
 #undef min
 #undef max
+#include "AsyncLogger.h"
+#include "CheckProfile.h"
+#include "DynamicFieldChecker.h"
+#include "FieldChecks.h"
+#include "FrameCapture.h"
+#include "MissingFieldMap.h"
+#include "ObjectRecall.h"
+#include "TemporalConsistency.h"
 #include "osi_sensordata.pb.h"
 #include "osi_sensorview.pb.h"
 
 using namespace std;
 
+static_assert(FMI_INTEGER_FIELD_CHECKED_SIZE == kFieldCheckCount && FMI_INTEGER_FIELD_MISSING_SIZE == kFieldCheckCount &&
+                  FMI_INTEGER_FIELD_MISSING_FRAMES_SIZE == kFieldCheckCount && FMI_REAL_FIELD_FILL_RATE_SIZE == kFieldCheckCount,
+              "field statistics variables have to match the field checks");
+
+/* OSMP encoding of buffer addresses in two integer variables */
+void* DecodeIntegerToPointer(fmi2Integer hi, fmi2Integer lo);
+void EncodePointerToInteger(const void* ptr, fmi2Integer& hi, fmi2Integer& lo);
+
 /* FMU Class */
 class OSIFieldChecker
 {
@@ -92,6 +153,7 @@ public:
                   const fmi2CallbackFunctions* thefunctions,
                   fmi2Boolean thevisible,
                   fmi2Boolean thelogging_on);
+  virtual ~OSIFieldChecker() = default;
   fmi2Status SetDebugLogging(fmi2Boolean thelogging_on, size_t n_categories, const fmi2String categories[]);
   static fmi2Component Instantiate(fmi2String instance_name,
                                    fmi2Type fmu_type,
@@ -122,13 +184,57 @@ protected:
   fmi2Status DoExitInitializationMode();
   fmi2Status DoCalc(fmi2Real current_communication_point, fmi2Real communication_step_size);
   static fmi2Status DoTerm();
-  void CheckMovingObjects(const osi3::SensorData& sensor_data_in, const fmi2Real& current_communication_point);
+  bool CheckFrameBatch(const void* buffer, int size, const fmi2Real& current_communication_point, const chrono::steady_clock::time_point& step_start);
+  void CheckFrame(const void* buffer, int size, fmi2Real current_communication_point, bool use_frame_timestamp, const chrono::steady_clock::time_point& step_start);
+  void CheckDynamicSensorData(const void* buffer, int size, const fmi2Real& current_communication_point);
+  void DisableUnavailableDynamicChecks();
+  string ResourcePath(const string& file_name) const;
+  void UpdateSampling(FieldCheckMask missing, const fmi2Real& current_communication_point);
+  FieldCheckMask CheckSensorData(const osi3::SensorData& sensor_data_in, const fmi2Real& current_communication_point, const chrono::steady_clock::time_point& step_start);
+  void BuildSchedule(const osi3::SensorData& sensor_data_in);
+  FieldCheckMask CheckScheduledUnit(const osi3::SensorData& sensor_data_in, size_t unit, FieldCounts& counts);
+  FieldCheckMask CheckScheduledUnits(const osi3::SensorData& sensor_data_in, const chrono::steady_clock::time_point& step_start, FieldCounts& counts);
+  void ReportMissingFields(FieldCheckMask missing, const FieldCounts& counts, const fmi2Real& current_communication_point);
+  void CheckTemporalConsistency(const osi3::SensorData& sensor_data_in, const fmi2Real& current_communication_point);
+  void CheckObjectRecall(const void* buffer, int size, const fmi2Real& current_communication_point);
+  void ResetRunState();
+  void OpenFrameCapture();
+  void CaptureFrame(bool offending, const void* buffer, int size);
+  void SetFmiFieldStatistics();
+  void RecordMissingField(const string& field_name);
+  size_t MemoryUsage();
+  /* Buffers of a derived FMI variant that count against the memory budget, and their release when it is exceeded */
+  virtual size_t VariantMemoryUsage() const { return 0; }
+  virtual void ReleaseVariantBuffers() {}
+  bool OverMemoryBudget(size_t bytes);
+  void ShrinkBuffers(bool release_all);
+  void RecordMemoryUsage(size_t peak_bytes, size_t current_bytes);
+  void EnforceMemoryBudget();
+
+  /*
+   * Logging
+   *
+   * Log calls only record the format and arguments in the AsyncLogger of
+   * the instance, formatting and output to the private log file and the
+   * FMI logger are done by its background thread.  The FMI logger callback
+   * is therefore called from that thread, possibly while the master is in
+   * another FMI call of the instance or in none at all, and all messages
+   * are passed before fmi2Terminate returns.  Categories missing in
+   * LOG_CATEGORY_MASK are removed at compile time.
+   */
+  enum LogSink : uint32_t
+  {
+    kLogSinkPrivateFile = 1U,
+    kLogSinkFmiLogger = 2U
+  };
 
   /* Private File-based Logging just for Debugging */
 #ifdef PRIVATE_LOG_PATH
   static ofstream private_log_file;
+  static std::mutex private_log_mutex;
 #endif
 
+  /* Synchronous, only used before an instance exists */
   static void FmiVerboseLogGlobal(const char* format, ...)
   {
 #ifdef VERBOSE_FMI_LOGGING
@@ -136,67 +242,58 @@ protected:
     va_list ap;
     va_start(ap, format);
     char buffer[1024];
-    if (!private_log_file.is_open())
-      private_log_file.open(PRIVATE_LOG_PATH, ios::out | ios::app);
-    if (private_log_file.is_open())
-    {
 #ifdef _WIN32
-      vsnprintf_s(buffer, 1024, format, ap);
+    vsnprintf_s(buffer, 1024, format, ap);
 #else
-      vsnprintf(buffer, 1024, format, ap);
-#endif
-      private_log_file << "OSMPDummySensor"
-                       << "::Global:FMI: " << buffer << endl;
-      private_log_file.flush();
-    }
+    vsnprintf(buffer, 1024, format, ap);
 #endif
-#endif
-  }
-
-  void InternalLog(const char* category, const char* format, va_list arg)
-  {
-#if defined(PRIVATE_LOG_PATH) || defined(PUBLIC_LOGGING)
-    char buffer[1024];
-#ifdef _WIN32
-    vsnprintf_s(buffer, 1024, format, arg);
-#else
-    vsnprintf(buffer, 1024, format, arg);
-#endif
-#ifdef PRIVATE_LOG_PATH
+    va_end(ap);
+    std::lock_guard<std::mutex> lock(private_log_mutex);
     if (!private_log_file.is_open())
       private_log_file.open(PRIVATE_LOG_PATH, ios::out | ios::app);
     if (private_log_file.is_open())
     {
-      private_log_file << "OSMPDummySensor"
-                       << "::" << instanceName << "<" << ((void*)this) << ">:" << category << ": " << buffer << endl;
-      private_log_file.flush();
+      private_log_file << "OSIFieldChecker"
+                       << "::Global:FMI: " << buffer << endl;
     }
 #endif
-#ifdef PUBLIC_LOGGING
-    if (loggingOn && loggingCategories.count(category))
-      functions.logger(functions.componentEnvironment, instanceName.c_str(), fmi2OK, category, buffer);
-#endif
 #endif
   }
 
-  void FmiVerboseLog(const char* format, ...)
+  /* Output of formatted messages, called on the logger thread */
+  void WriteLog(LogCategory category, uint32_t sinks, const char* message);
+
+  template <typename... Args>
+  void FmiVerboseLog(const char* format, const Args&... args)
   {
-#if defined(VERBOSE_FMI_LOGGING) && (defined(PRIVATE_LOG_PATH) || defined(PUBLIC_LOGGING))
-    va_list ap;
-    va_start(ap, format);
-    internal_log("FMI", format, ap);
-    va_end(ap);
+#ifdef VERBOSE_FMI_LOGGING
+    NormalLog<kLogFmi>(format, args...);
 #endif
   }
 
   /* Normal Logging */
-  void NormalLog(const char* category, const char* format, ...)
+  template <LogCategory kCategory, typename... Args>
+  void NormalLog(const char* format, const Args&... args)
   {
 #if defined(PRIVATE_LOG_PATH) || defined(PUBLIC_LOGGING)
-    va_list ap;
-    va_start(ap, format);
-    internal_log(category, format, ap);
-    va_end(ap);
+    if ((LOG_CATEGORY_MASK & kCategory) == 0)
+    {
+      return;
+    }
+    uint32_t sinks = 0;
+#ifdef PRIVATE_LOG_PATH
+    sinks |= kLogSinkPrivateFile;
+#endif
+#ifdef PUBLIC_LOGGING
+    if (logging_on_ && (logging_categories_ & kCategory) != 0)
+    {
+      sinks |= kLogSinkFmiLogger;
+    }
+#endif
+    if (sinks != 0)
+    {
+      logger_->Log(kCategory, sinks, format, args...);
+    }
 #endif
   }
 
@@ -207,19 +304,83 @@ protected:
   string fmu_resource_location_;
   bool visible_;
   bool logging_on_;
-  set<string> logging_categories_;
+  uint32_t logging_categories_;
   fmi2CallbackFunctions functions_;
   fmi2Boolean boolean_vars_[FMI_BOOLEAN_VARS]{};
   fmi2Integer integer_vars_[FMI_INTEGER_VARS]{};
   fmi2Real real_vars_[FMI_REAL_VARS]{};
   string string_vars_[FMI_STRING_VARS];
   bool simulation_started_;
-  string* current_output_buffer_;
-  string* last_output_buffer_;
+  std::unique_ptr<string> current_output_buffer_;  // swapped as pointers, so the data of the published frame stays in place
+  std::unique_ptr<string> last_output_buffer_;
   // string* currentConfigRequestBuffer;
   // string* lastConfigRequestBuffer;
-  std::set<string> expected_osi_fields_;
+  std::shared_ptr<const CheckProfile> check_profile_;
+  string loaded_check_file_;
+  string loaded_descriptor_set_;
   std::set<string> missing_fields_;
+  size_t missing_fields_bytes_ = 0;
+  uint64_t missing_fields_dropped_ = 0;
+  FieldStatistics field_statistics_;
+  FieldCheckMask enabled_checks_ = 0;
+
+  /*
+   * Check schedule of the current frame.  Every moving object and every
+   * chunk of kDetectionChunkSize detections is one unit of work, so the
+   * step time budget can be checked between units.
+   */
+  enum ScheduleKind
+  {
+    kScheduleMovingObjects,
+    kScheduleLidarDetections,
+    kScheduleRadarDetections
+  };
+  struct ScheduleSegment
+  {
+    ScheduleKind kind;
+    int sensor;
+    size_t first_unit;
+    size_t unit_count;
+  };
+  static const size_t kDetectionChunkSize = 4096;
+  std::vector<ScheduleSegment> schedule_;
+  size_t schedule_cursor_ = 0;
+
+  /* Adaptive sampling state and coverage */
+  bool sampling_active_ = false;
+  FieldCheckMask presence_signature_ = 0;
+  uint64_t stable_frames_ = 0;
+  size_t sample_phase_ = 0;
+  uint64_t frames_received_ = 0;
+  uint64_t frames_checked_ = 0;
+  uint64_t units_scheduled_ = 0;
+  uint64_t units_checked_ = 0;
+  bool check_timestamp_monotonic_ = false;
+  bool check_tracking_id_persistence_ = false;
+  TemporalConsistencyChecker temporal_checker_;
+  DynamicFieldChecker dynamic_field_checker_;
+  std::vector<int> dynamic_field_checks_;  // field check of each dynamic result, -1 for field paths without one
+  osi3::SensorData sensor_data_in_;  // reused for every frame to keep the parsed message allocations
+  bool last_frame_parsed_ = false;
+  FrameCapture frame_capture_;
+  bool check_object_recall_ = false;
+  ObjectRecallChecker object_recall_checker_;
+  osi3::SensorView sensor_view_in_;  // reused like sensor_data_in_
+  MissingFieldMap missing_field_map_;
+
+  /*
+   * Memory accounting.  Measuring the parsed messages walks them, so they
+   * are only measured again when more input bytes than at the last
+   * measurement were parsed, as reused messages only grow with the input.
+   */
+  size_t parsed_input_bytes_ = 0;
+  size_t measured_input_bytes_ = 0;
+  size_t parsed_memory_bytes_ = 0;
+  size_t memory_peak_bytes_ = 0;
+  uint64_t memory_budget_overruns_ = 0;
+#if defined(PRIVATE_LOG_PATH) || defined(PUBLIC_LOGGING)
+  std::unique_ptr<AsyncLogger> logger_;  // declared last, so its thread is stopped before the other members go away
+#endif
 
   /* Simple Accessors */
   fmi2Boolean FmiValid()
@@ -238,6 +399,70 @@ protected:
   {
     integer_vars_[FMI_INTEGER_COUNT_IDX] = value;
   }
+  fmi2Integer FmiTemporalMaxTrackedIds()
+  {
+    return integer_vars_[FMI_INTEGER_TEMPORAL_MAX_TRACKED_IDS_IDX];
+  }
+  fmi2Integer FmiTemporalMaxAbsentFrames()
+  {
+    return integer_vars_[FMI_INTEGER_TEMPORAL_MAX_ABSENT_FRAMES_IDX];
+  }
+  fmi2Integer FmiStepTimeBudgetUs()
+  {
+    return integer_vars_[FMI_INTEGER_STEP_TIME_BUDGET_US_IDX];
+  }
+  fmi2Integer FmiDeadlineMissCount()
+  {
+    return integer_vars_[FMI_INTEGER_DEADLINE_MISS_COUNT_IDX];
+  }
+  void SetFmiDeadlineMissCount(fmi2Integer value)
+  {
+    integer_vars_[FMI_INTEGER_DEADLINE_MISS_COUNT_IDX] = value;
+  }
+  fmi2Integer FmiSampleFrameStride()
+  {
+    return integer_vars_[FMI_INTEGER_SAMPLE_FRAME_STRIDE_IDX];
+  }
+  fmi2Integer FmiSampleObjectStride()
+  {
+    return integer_vars_[FMI_INTEGER_SAMPLE_OBJECT_STRIDE_IDX];
+  }
+  fmi2Integer FmiSampleStableFrames()
+  {
+    return integer_vars_[FMI_INTEGER_SAMPLE_STABLE_FRAMES_IDX];
+  }
+  fmi2Real FmiCheckStartTime()
+  {
+    return real_vars_[FMI_REAL_CHECK_START_TIME_IDX];
+  }
+  fmi2Real FmiMinFillRate()
+  {
+    return real_vars_[FMI_REAL_MIN_FILL_RATE_IDX];
+  }
+  void SetFmiCheckCoverage(fmi2Real value)
+  {
+    real_vars_[FMI_REAL_CHECK_COVERAGE_IDX] = value;
+  }
+  fmi2Real FmiNominalRange()
+  {
+    return real_vars_[FMI_REAL_NOMINAL_RANGE_IDX];
+  }
+  void SetFmiObjectRecall(fmi2Real value)
+  {
+    real_vars_[FMI_REAL_OBJECT_RECALL_IDX] = value;
+  }
+  fmi2Real FmiRecallFovHorizontal()
+  {
+    return real_vars_[FMI_REAL_RECALL_FOV_HORIZONTAL_IDX];
+  }
+  fmi2Real FmiRecallFovVertical()
+  {
+    return real_vars_[FMI_REAL_RECALL_FOV_VERTICAL_IDX];
+  }
+  void SetFmiMissedObjectCount(fmi2Integer value)
+  {
+    integer_vars_[FMI_INTEGER_MISSED_OBJECT_COUNT_IDX] = value;
+  }
   string FmiCheckFile()
   {
     return string_vars_[FMI_STRING_CHECK_FILE_IDX];
@@ -246,13 +471,70 @@ protected:
   {
     string_vars_[FMI_STRING_CHECK_FILE_IDX] = value;
   }
+  string FmiDescriptorSet()
+  {
+    return string_vars_[FMI_STRING_DESCRIPTOR_SET_IDX];
+  }
+  string FmiCaptureFile()
+  {
+    return string_vars_[FMI_STRING_CAPTURE_FILE_IDX];
+  }
+  fmi2Integer FmiCaptureFirstOccurrences()
+  {
+    return integer_vars_[FMI_INTEGER_CAPTURE_FIRST_OCCURRENCES_IDX];
+  }
+  fmi2Integer FmiCaptureOccurrenceStride()
+  {
+    return integer_vars_[FMI_INTEGER_CAPTURE_OCCURRENCE_STRIDE_IDX];
+  }
+  fmi2Integer FmiCaptureMaxMegabytes()
+  {
+    return integer_vars_[FMI_INTEGER_CAPTURE_MAX_MEGABYTES_IDX];
+  }
+  void SetFmiCapturedFrameCount(fmi2Integer value)
+  {
+    integer_vars_[FMI_INTEGER_CAPTURED_FRAME_COUNT_IDX] = value;
+  }
+  string FmiMissingMapFile()
+  {
+    return string_vars_[FMI_STRING_MISSING_MAP_FILE_IDX];
+  }
+  fmi2Integer FmiMissingMapRangeBins()
+  {
+    return integer_vars_[FMI_INTEGER_MISSING_MAP_RANGE_BINS_IDX];
+  }
+  fmi2Integer FmiMissingMapAzimuthBins()
+  {
+    return integer_vars_[FMI_INTEGER_MISSING_MAP_AZIMUTH_BINS_IDX];
+  }
+  fmi2Integer FmiMemoryBudgetMegabytes()
+  {
+    return integer_vars_[FMI_INTEGER_MEMORY_BUDGET_MEGABYTES_IDX];
+  }
+  fmi2Integer FmiMaxMissingFieldNames()
+  {
+    return integer_vars_[FMI_INTEGER_MAX_MISSING_FIELD_NAMES_IDX];
+  }
+  void SetFmiMemoryCurrentKilobytes(fmi2Integer value)
+  {
+    integer_vars_[FMI_INTEGER_MEMORY_CURRENT_KILOBYTES_IDX] = value;
+  }
+  void SetFmiMemoryPeakKilobytes(fmi2Integer value)
+  {
+    integer_vars_[FMI_INTEGER_MEMORY_PEAK_KILOBYTES_IDX] = value;
+  }
 
   /* Protocol Buffer Accessors */
   // bool get_fmi_sensor_view_config(osi3::SensorViewConfiguration& data);
   // void set_fmi_sensor_view_config_request(const osi3::SensorViewConfiguration& data);
   // void reset_fmi_sensor_view_config_request();
-  bool GetFmiSensorDataIn(osi3::SensorData& data);
+  bool GetFmiSensorDataInBuffer(const void*& buffer, int& size);
+  bool GetFmiSensorDataBatchInBuffer(const void*& buffer, int& size);
+  bool GetFmiSensorViewInBuffer(const void*& buffer, int& size);
   void SetFmiSensorDataOut(const osi3::SensorData& data);
+  void SetFmiSensorDataOut(const void* buffer, int size);
+  void SetFmiSensorDataOutFromFrame(const void* buffer, int size);
+  void PublishFmiSensorDataOut();
   void ResetFmiSensorDataOut();
 
   /* Refreshing of Calculated Parameters */
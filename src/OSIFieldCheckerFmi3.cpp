@@ -0,0 +1,1027 @@
+//
+// Copyright 2023 BMW AG
+// SPDX-License-Identifier: MPL-2.0
+//
+
+#include "OSIFieldCheckerFmi3.h"
+
+#include <cstdarg>
+#include <cstdint>
+#include <string>
+
+using namespace std;
+
+namespace
+{
+
+fmi3Status ToFmi3Status(fmi2Status status)
+{
+  switch (status)
+  {
+    case fmi2OK:
+      return fmi3OK;
+    case fmi2Warning:
+      return fmi3Warning;
+    case fmi2Discard:
+      return fmi3Discard;
+    case fmi2Fatal:
+      return fmi3Fatal;
+    default:
+      return fmi3Error;
+  }
+}
+
+/* Number of values of the variable starting at the given index, the field statistics are arrays in FMI 3.0 */
+size_t Int32VariableSize(size_t index)
+{
+  if (index == FMI_INTEGER_FIELD_CHECKED_OFFSET)
+  {
+    return FMI_INTEGER_FIELD_CHECKED_SIZE;
+  }
+  if (index == FMI_INTEGER_FIELD_MISSING_OFFSET)
+  {
+    return FMI_INTEGER_FIELD_MISSING_SIZE;
+  }
+  if (index == FMI_INTEGER_FIELD_MISSING_FRAMES_OFFSET)
+  {
+    return FMI_INTEGER_FIELD_MISSING_FRAMES_SIZE;
+  }
+  return 1;
+}
+
+size_t Float64VariableSize(size_t index)
+{
+  return (index == FMI_REAL_FIELD_FILL_RATE_OFFSET) ? FMI_REAL_FIELD_FILL_RATE_SIZE : 1;
+}
+
+size_t ScalarVariableSize(size_t /*index*/)
+{
+  return 1;
+}
+
+template <typename T, typename V>
+fmi3Status GetVariables(const fmi3ValueReference vr[],
+                        size_t nvr,
+                        T values[],
+                        size_t n_values,
+                        fmi3ValueReference vr_offset,
+                        const V variables[],
+                        size_t variable_count,
+                        size_t (*variable_size)(size_t))
+{
+  size_t value_index = 0;
+  for (size_t i = 0; i < nvr; i++)
+  {
+    if (vr[i] < vr_offset || vr[i] - vr_offset >= variable_count)
+    {
+      return fmi3Error;
+    }
+    const size_t index = vr[i] - vr_offset;
+    const size_t size = variable_size(index);
+    if (value_index + size > n_values)
+    {
+      return fmi3Error;
+    }
+    for (size_t j = 0; j < size; j++)
+    {
+      values[value_index++] = static_cast<T>(variables[index + j]);
+    }
+  }
+  return fmi3OK;
+}
+
+template <typename T, typename V>
+fmi3Status SetVariables(const fmi3ValueReference vr[],
+                        size_t nvr,
+                        const T values[],
+                        size_t n_values,
+                        fmi3ValueReference vr_offset,
+                        V variables[],
+                        size_t variable_count,
+                        size_t (*variable_size)(size_t))
+{
+  size_t value_index = 0;
+  for (size_t i = 0; i < nvr; i++)
+  {
+    if (vr[i] < vr_offset || vr[i] - vr_offset >= variable_count)
+    {
+      return fmi3Error;
+    }
+    const size_t index = vr[i] - vr_offset;
+    const size_t size = variable_size(index);
+    if (value_index + size > n_values)
+    {
+      return fmi3Error;
+    }
+    for (size_t j = 0; j < size; j++)
+    {
+      variables[index + j] = static_cast<V>(values[value_index++]);
+    }
+  }
+  return fmi3OK;
+}
+
+}  // namespace
+
+/*
+ * FMI 3.0 C++ Wrapper Code
+ */
+
+Fmi3LogForwarder::Fmi3LogForwarder(fmi3InstanceEnvironment theinstance_environment, fmi3LogMessageCallback thelog_message)
+    : instance_environment(theinstance_environment), log_message(thelog_message), functions{LogMessage, nullptr, nullptr, nullptr, this}
+{
+}
+
+void Fmi3LogForwarder::LogMessage(fmi2ComponentEnvironment component_environment,
+                                  fmi2String /*instance_name*/,
+                                  fmi2Status status,
+                                  fmi2String category,
+                                  fmi2String message,
+                                  ...)
+{
+  auto* forwarder = static_cast<Fmi3LogForwarder*>(component_environment);
+  if (forwarder->log_message != nullptr)
+  {
+    forwarder->log_message(forwarder->instance_environment, ToFmi3Status(status), category, message);
+  }
+}
+
+OSIFieldCheckerFmi3::OSIFieldCheckerFmi3(fmi3String theinstance_name,
+                                         fmi3String theinstantiation_token,
+                                         fmi3String theresource_path,
+                                         fmi3Boolean thevisible,
+                                         fmi3Boolean thelogging_on,
+                                         fmi3Boolean theevent_mode_used,
+                                         fmi3InstanceEnvironment theinstance_environment,
+                                         fmi3LogMessageCallback thelog_message)
+    : Fmi3LogForwarder(theinstance_environment, thelog_message),
+      OSIFieldChecker(theinstance_name,
+                      fmi2CoSimulation,
+                      theinstantiation_token,
+                      (theresource_path != nullptr) ? theresource_path : "",
+                      &functions,
+                      thevisible ? fmi2True : fmi2False,
+                      thelogging_on ? fmi2True : fmi2False),
+      event_mode_used_(theevent_mode_used)
+{
+}
+
+fmi3Instance OSIFieldCheckerFmi3::Instantiate(fmi3String instance_name,
+                                              fmi3String instantiation_token,
+                                              fmi3String resource_path,
+                                              fmi3Boolean visible,
+                                              fmi3Boolean logging_on,
+                                              fmi3Boolean event_mode_used,
+                                              fmi3Boolean early_return_allowed,
+                                              const fmi3ValueReference required_intermediate_variables[],
+                                              size_t n_required_intermediate_variables,
+                                              fmi3InstanceEnvironment instance_environment,
+                                              fmi3LogMessageCallback log_message,
+                                              fmi3IntermediateUpdateCallback intermediate_update)
+{
+  auto* myc = new OSIFieldCheckerFmi3(instance_name, instantiation_token, resource_path, visible, logging_on, event_mode_used, instance_environment, log_message);
+
+  FmiVerboseLogGlobal(R"(fmi3InstantiateCoSimulation("%s","%s","%s",%d,%d,%d,%d) = %p)",
+                      instance_name,
+                      instantiation_token,
+                      (resource_path != nullptr) ? resource_path : "<NULL>",
+                      visible,
+                      logging_on,
+                      event_mode_used,
+                      early_return_allowed,
+                      myc);
+  return myc;
+}
+
+fmi3Status OSIFieldCheckerFmi3::EnterInitializationMode(fmi3Float64 start_time)
+{
+  current_time_ = start_time;
+  return ToFmi3Status(OSIFieldChecker::EnterInitializationMode());
+}
+
+fmi3Status OSIFieldCheckerFmi3::ExitInitializationMode()
+{
+  return ToFmi3Status(OSIFieldChecker::ExitInitializationMode());
+}
+
+fmi3Status OSIFieldCheckerFmi3::EnterEventMode()
+{
+  FmiVerboseLog("fmi3EnterEventMode()");
+  return fmi3OK;
+}
+
+fmi3Status OSIFieldCheckerFmi3::UpdateDiscreteStates(fmi3Boolean* discrete_states_need_update,
+                                                     fmi3Boolean* terminate_simulation,
+                                                     fmi3Boolean* nominals_of_continuous_states_changed,
+                                                     fmi3Boolean* values_of_continuous_states_changed,
+                                                     fmi3Boolean* next_event_time_defined,
+                                                     fmi3Float64* next_event_time)
+{
+  FmiVerboseLog("fmi3UpdateDiscreteStates()");
+  if (input_clock_active_)
+  {
+    CheckNewFrame(current_time_);
+  }
+  *discrete_states_need_update = fmi3False;
+  *terminate_simulation = fmi3False;
+  *nominals_of_continuous_states_changed = fmi3False;
+  *values_of_continuous_states_changed = fmi3False;
+  *next_event_time_defined = fmi3False;
+  *next_event_time = 0.0;
+  return fmi3OK;
+}
+
+fmi3Status OSIFieldCheckerFmi3::EnterStepMode()
+{
+  FmiVerboseLog("fmi3EnterStepMode()");
+  input_clock_active_ = false;  // clocks are deactivated when the event ends
+  return fmi3OK;
+}
+
+fmi3Status OSIFieldCheckerFmi3::DoStep(fmi3Float64 current_communication_point,
+                                       fmi3Float64 communication_step_size,
+                                       fmi3Boolean no_set_fmu_state_prior_to_current_point,
+                                       fmi3Boolean* event_handling_needed,
+                                       fmi3Boolean* terminate_simulation,
+                                       fmi3Boolean* early_return,
+                                       fmi3Float64* last_successful_time)
+{
+  FmiVerboseLog("fmi3DoStep(%g,%g,%d)", current_communication_point, communication_step_size, no_set_fmu_state_prior_to_current_point);
+
+  /* Without event mode, a frame set in step mode is checked in the next step, steps without a new frame do no work */
+  if (new_frame_)
+  {
+    CheckNewFrame(current_communication_point);
+  }
+  current_time_ = current_communication_point + communication_step_size;
+  *event_handling_needed = (event_mode_used_ && output_clock_active_) ? fmi3True : fmi3False;
+  *terminate_simulation = fmi3False;
+  *early_return = fmi3False;
+  *last_successful_time = current_time_;
+  return fmi3OK;
+}
+
+void OSIFieldCheckerFmi3::CheckNewFrame(fmi3Float64 current_communication_point)
+{
+  new_frame_ = false;
+  input_clock_active_ = false;
+  DoCalc(current_communication_point, 0.0);
+  integer_vars_[FMI_INTEGER_SENSORDATA_IN_SIZE_IDX] = 0;
+  integer_vars_[FMI_INTEGER_SENSORDATA_BATCH_IN_SIZE_IDX] = 0;
+  integer_vars_[FMI_INTEGER_SENSORVIEW_IN_SIZE_IDX] = 0;
+  output_clock_active_ = true;
+  EnforceMemoryBudget();  // the copies of the binary inputs are consumed at this point
+}
+
+size_t OSIFieldCheckerFmi3::VariantMemoryUsage() const
+{
+  return sizeof(*this) - sizeof(OSIFieldChecker) + sensor_data_in_buffer_.capacity() + sensor_data_batch_in_buffer_.capacity() + sensor_view_in_buffer_.capacity();
+}
+
+void OSIFieldCheckerFmi3::ReleaseVariantBuffers()
+{
+  string().swap(sensor_data_in_buffer_);
+  string().swap(sensor_data_batch_in_buffer_);
+  string().swap(sensor_view_in_buffer_);
+}
+
+fmi3Status OSIFieldCheckerFmi3::Terminate()
+{
+  return ToFmi3Status(OSIFieldChecker::Terminate());
+}
+
+fmi3Status OSIFieldCheckerFmi3::Reset()
+{
+  new_frame_ = false;
+  input_clock_active_ = false;
+  output_clock_active_ = false;
+  integer_vars_[FMI_INTEGER_SENSORDATA_IN_SIZE_IDX] = 0;
+  integer_vars_[FMI_INTEGER_SENSORDATA_BATCH_IN_SIZE_IDX] = 0;
+  integer_vars_[FMI_INTEGER_SENSORVIEW_IN_SIZE_IDX] = 0;
+  return ToFmi3Status(OSIFieldChecker::Reset());
+}
+
+fmi3Status OSIFieldCheckerFmi3::GetFloat64(const fmi3ValueReference vr[], size_t nvr, fmi3Float64 values[], size_t n_values)
+{
+  FmiVerboseLog("fmi3GetFloat64(...)");
+  return GetVariables(vr, nvr, values, n_values, FMI3_VR_FLOAT64_OFFSET, real_vars_, FMI_REAL_VARS, Float64VariableSize);
+}
+
+fmi3Status OSIFieldCheckerFmi3::GetInt32(const fmi3ValueReference vr[], size_t nvr, fmi3Int32 values[], size_t n_values)
+{
+  FmiVerboseLog("fmi3GetInt32(...)");
+  return GetVariables(vr, nvr, values, n_values, FMI3_VR_INT32_OFFSET, integer_vars_, FMI_INTEGER_VARS, Int32VariableSize);
+}
+
+fmi3Status OSIFieldCheckerFmi3::GetBoolean(const fmi3ValueReference vr[], size_t nvr, fmi3Boolean values[], size_t n_values)
+{
+  FmiVerboseLog("fmi3GetBoolean(...)");
+  return GetVariables(vr, nvr, values, n_values, FMI3_VR_BOOLEAN_OFFSET, boolean_vars_, FMI_BOOLEAN_VARS, ScalarVariableSize);
+}
+
+fmi3Status OSIFieldCheckerFmi3::GetString(const fmi3ValueReference vr[], size_t nvr, fmi3String values[], size_t n_values)
+{
+  FmiVerboseLog("fmi3GetString(...)");
+  if (nvr > n_values)
+  {
+    return fmi3Error;
+  }
+  for (size_t i = 0; i < nvr; i++)
+  {
+    if (vr[i] >= FMI3_VR_STRING_OFFSET && vr[i] - FMI3_VR_STRING_OFFSET < FMI_STRING_VARS)
+    {
+      values[i] = string_vars_[vr[i] - FMI3_VR_STRING_OFFSET].c_str();
+    }
+    else
+    {
+      return fmi3Error;
+    }
+  }
+  return fmi3OK;
+}
+
+fmi3Status OSIFieldCheckerFmi3::GetBinary(const fmi3ValueReference vr[], size_t nvr, size_t value_sizes[], fmi3Binary values[], size_t n_values)
+{
+  FmiVerboseLog("fmi3GetBinary(...)");
+  if (nvr > n_values)
+  {
+    return fmi3Error;
+  }
+  for (size_t i = 0; i < nvr; i++)
+  {
+    if (vr[i] == FMI3_VR_SENSORDATA_OUT)
+    {
+      /* The output buffer stays valid until the next frame is checked, so it is passed without copy */
+      values[i] = static_cast<fmi3Binary>(
+          DecodeIntegerToPointer(integer_vars_[FMI_INTEGER_SENSORDATA_OUT_BASEHI_IDX], integer_vars_[FMI_INTEGER_SENSORDATA_OUT_BASELO_IDX]));
+      value_sizes[i] = static_cast<size_t>(integer_vars_[FMI_INTEGER_SENSORDATA_OUT_SIZE_IDX]);
+    }
+    else
+    {
+      return fmi3Error;
+    }
+  }
+  return fmi3OK;
+}
+
+fmi3Status OSIFieldCheckerFmi3::GetClock(const fmi3ValueReference vr[], size_t nvr, fmi3Clock values[])
+{
+  FmiVerboseLog("fmi3GetClock(...)");
+  for (size_t i = 0; i < nvr; i++)
+  {
+    if (vr[i] == FMI3_VR_SENSORDATA_OUT_CLOCK)
+    {
+      values[i] = output_clock_active_ ? fmi3ClockActive : fmi3ClockInactive;
+      output_clock_active_ = false;  // an output clock tick is reported only once
+    }
+    else
+    {
+      return fmi3Error;
+    }
+  }
+  return fmi3OK;
+}
+
+fmi3Status OSIFieldCheckerFmi3::SetFloat64(const fmi3ValueReference vr[], size_t nvr, const fmi3Float64 values[], size_t n_values)
+{
+  FmiVerboseLog("fmi3SetFloat64(...)");
+  return SetVariables(vr, nvr, values, n_values, FMI3_VR_FLOAT64_OFFSET, real_vars_, FMI_REAL_VARS, Float64VariableSize);
+}
+
+fmi3Status OSIFieldCheckerFmi3::SetInt32(const fmi3ValueReference vr[], size_t nvr, const fmi3Int32 values[], size_t n_values)
+{
+  FmiVerboseLog("fmi3SetInt32(...)");
+  return SetVariables(vr, nvr, values, n_values, FMI3_VR_INT32_OFFSET, integer_vars_, FMI_INTEGER_VARS, Int32VariableSize);
+}
+
+fmi3Status OSIFieldCheckerFmi3::SetBoolean(const fmi3ValueReference vr[], size_t nvr, const fmi3Boolean values[], size_t n_values)
+{
+  FmiVerboseLog("fmi3SetBoolean(...)");
+  return SetVariables(vr, nvr, values, n_values, FMI3_VR_BOOLEAN_OFFSET, boolean_vars_, FMI_BOOLEAN_VARS, ScalarVariableSize);
+}
+
+fmi3Status OSIFieldCheckerFmi3::SetString(const fmi3ValueReference vr[], size_t nvr, const fmi3String values[], size_t n_values)
+{
+  FmiVerboseLog("fmi3SetString(...)");
+  if (nvr > n_values)
+  {
+    return fmi3Error;
+  }
+  for (size_t i = 0; i < nvr; i++)
+  {
+    if (vr[i] >= FMI3_VR_STRING_OFFSET && vr[i] - FMI3_VR_STRING_OFFSET < FMI_STRING_VARS)
+    {
+      string_vars_[vr[i] - FMI3_VR_STRING_OFFSET] = (values[i] != nullptr) ? values[i] : "";
+    }
+    else
+    {
+      return fmi3Error;
+    }
+  }
+  return fmi3OK;
+}
+
+fmi3Status OSIFieldCheckerFmi3::SetBinary(const fmi3ValueReference vr[], size_t nvr, const size_t value_sizes[], const fmi3Binary values[], size_t n_values)
+{
+  FmiVerboseLog("fmi3SetBinary(...)");
+  if (nvr > n_values)
+  {
+    return fmi3Error;
+  }
+  for (size_t i = 0; i < nvr; i++)
+  {
+    if (value_sizes[i] > static_cast<size_t>(INT32_MAX))
+    {
+      return fmi3Error;
+    }
+    if (vr[i] == FMI3_VR_SENSORDATA_IN)
+    {
+      SetFmiBinaryIn(FMI_INTEGER_SENSORDATA_IN_BASELO_IDX,
+                     FMI_INTEGER_SENSORDATA_IN_BASEHI_IDX,
+                     FMI_INTEGER_SENSORDATA_IN_SIZE_IDX,
+                     sensor_data_in_buffer_,
+                     values[i],
+                     value_sizes[i]);
+      new_frame_ = new_frame_ || (!event_mode_used_ && value_sizes[i] > 0);
+    }
+    else if (vr[i] == FMI3_VR_SENSORDATA_BATCH_IN)
+    {
+      SetFmiBinaryIn(FMI_INTEGER_SENSORDATA_BATCH_IN_BASELO_IDX,
+                     FMI_INTEGER_SENSORDATA_BATCH_IN_BASEHI_IDX,
+                     FMI_INTEGER_SENSORDATA_BATCH_IN_SIZE_IDX,
+                     sensor_data_batch_in_buffer_,
+                     values[i],
+                     value_sizes[i]);
+      new_frame_ = new_frame_ || (!event_mode_used_ && value_sizes[i] > 0);
+    }
+    else if (vr[i] == FMI3_VR_SENSORVIEW_IN)
+    {
+      SetFmiBinaryIn(FMI_INTEGER_SENSORVIEW_IN_BASELO_IDX,
+                     FMI_INTEGER_SENSORVIEW_IN_BASEHI_IDX,
+                     FMI_INTEGER_SENSORVIEW_IN_SIZE_IDX,
+                     sensor_view_in_buffer_,
+                     values[i],
+                     value_sizes[i]);
+    }
+    else
+    {
+      return fmi3Error;
+    }
+  }
+  return fmi3OK;
+}
+
+/* Copies the message into the reused input buffer and passes it to the checker like an OSMP input */
+void OSIFieldCheckerFmi3::SetFmiBinaryIn(int baselo_idx, int basehi_idx, int size_idx, string& buffer, const fmi3Binary value, size_t size)
+{
+  buffer.assign(reinterpret_cast<const char*>(value), size);
+  EncodePointerToInteger(buffer.data(), integer_vars_[basehi_idx], integer_vars_[baselo_idx]);
+  integer_vars_[size_idx] = static_cast<fmi2Integer>(size);
+}
+
+fmi3Status OSIFieldCheckerFmi3::SetClock(const fmi3ValueReference vr[], size_t nvr, const fmi3Clock values[])
+{
+  FmiVerboseLog("fmi3SetClock(...)");
+  for (size_t i = 0; i < nvr; i++)
+  {
+    if (vr[i] != FMI3_VR_SENSORDATA_IN_CLOCK)
+    {
+      return fmi3Error;
+    }
+    input_clock_active_ = values[i] == fmi3ClockActive;
+  }
+  return fmi3OK;
+}
+
+/*
+ * FMI 3.0 Co-Simulation Interface API
+ */
+
+extern "C" {
+
+FMI3_Export const char* fmi3GetVersion()
+{
+  return fmi3Version;
+}
+
+FMI3_Export fmi3Status fmi3SetDebugLogging(fmi3Instance instance, fmi3Boolean logging_on, size_t n_categories, const fmi3String categories[])
+{
+  auto* myc = (OSIFieldCheckerFmi3*)instance;
+  return ToFmi3Status(myc->SetDebugLogging(logging_on ? fmi2True : fmi2False, n_categories, categories));
+}
+
+FMI3_Export fmi3Instance fmi3InstantiateModelExchange(fmi3String instance_name,
+                                                      fmi3String instantiation_token,
+                                                      fmi3String resource_path,
+                                                      fmi3Boolean visible,
+                                                      fmi3Boolean logging_on,
+                                                      fmi3InstanceEnvironment instance_environment,
+                                                      fmi3LogMessageCallback log_message)
+{
+  return nullptr;
+}
+
+FMI3_Export fmi3Instance fmi3InstantiateCoSimulation(fmi3String instance_name,
+                                                     fmi3String instantiation_token,
+                                                     fmi3String resource_path,
+                                                     fmi3Boolean visible,
+                                                     fmi3Boolean logging_on,
+                                                     fmi3Boolean event_mode_used,
+                                                     fmi3Boolean early_return_allowed,
+                                                     const fmi3ValueReference required_intermediate_variables[],
+                                                     size_t n_required_intermediate_variables,
+                                                     fmi3InstanceEnvironment instance_environment,
+                                                     fmi3LogMessageCallback log_message,
+                                                     fmi3IntermediateUpdateCallback intermediate_update)
+{
+  return OSIFieldCheckerFmi3::Instantiate(instance_name,
+                                          instantiation_token,
+                                          resource_path,
+                                          visible,
+                                          logging_on,
+                                          event_mode_used,
+                                          early_return_allowed,
+                                          required_intermediate_variables,
+                                          n_required_intermediate_variables,
+                                          instance_environment,
+                                          log_message,
+                                          intermediate_update);
+}
+
+FMI3_Export fmi3Instance fmi3InstantiateScheduledExecution(fmi3String instance_name,
+                                                           fmi3String instantiation_token,
+                                                           fmi3String resource_path,
+                                                           fmi3Boolean visible,
+                                                           fmi3Boolean logging_on,
+                                                           fmi3InstanceEnvironment instance_environment,
+                                                           fmi3LogMessageCallback log_message,
+                                                           fmi3ClockUpdateCallback clock_update,
+                                                           fmi3LockPreemptionCallback lock_preemption,
+                                                           fmi3UnlockPreemptionCallback unlock_preemption)
+{
+  return nullptr;
+}
+
+FMI3_Export void fmi3FreeInstance(fmi3Instance instance)
+{
+  auto* myc = (OSIFieldCheckerFmi3*)instance;
+  myc->FreeInstance();
+  delete myc;
+}
+
+FMI3_Export fmi3Status fmi3EnterInitializationMode(fmi3Instance instance,
+                                                   fmi3Boolean tolerance_defined,
+                                                   fmi3Float64 tolerance,
+                                                   fmi3Float64 start_time,
+                                                   fmi3Boolean stop_time_defined,
+                                                   fmi3Float64 stop_time)
+{
+  auto* myc = (OSIFieldCheckerFmi3*)instance;
+  return myc->EnterInitializationMode(start_time);
+}
+
+FMI3_Export fmi3Status fmi3ExitInitializationMode(fmi3Instance instance)
+{
+  auto* myc = (OSIFieldCheckerFmi3*)instance;
+  return myc->ExitInitializationMode();
+}
+
+FMI3_Export fmi3Status fmi3EnterEventMode(fmi3Instance instance)
+{
+  auto* myc = (OSIFieldCheckerFmi3*)instance;
+  return myc->EnterEventMode();
+}
+
+FMI3_Export fmi3Status fmi3Terminate(fmi3Instance instance)
+{
+  auto* myc = (OSIFieldCheckerFmi3*)instance;
+  return myc->Terminate();
+}
+
+FMI3_Export fmi3Status fmi3Reset(fmi3Instance instance)
+{
+  auto* myc = (OSIFieldCheckerFmi3*)instance;
+  return myc->Reset();
+}
+
+/*
+ * Getting and setting variable values
+ */
+FMI3_Export fmi3Status fmi3GetFloat32(fmi3Instance instance, const fmi3ValueReference vr[], size_t nvr, fmi3Float32 values[], size_t n_values)
+{
+  return fmi3Error;
+}
+
+FMI3_Export fmi3Status fmi3GetFloat64(fmi3Instance instance, const fmi3ValueReference vr[], size_t nvr, fmi3Float64 values[], size_t n_values)
+{
+  auto* myc = (OSIFieldCheckerFmi3*)instance;
+  return myc->GetFloat64(vr, nvr, values, n_values);
+}
+
+FMI3_Export fmi3Status fmi3GetInt8(fmi3Instance instance, const fmi3ValueReference vr[], size_t nvr, fmi3Int8 values[], size_t n_values)
+{
+  return fmi3Error;
+}
+
+FMI3_Export fmi3Status fmi3GetUInt8(fmi3Instance instance, const fmi3ValueReference vr[], size_t nvr, fmi3UInt8 values[], size_t n_values)
+{
+  return fmi3Error;
+}
+
+FMI3_Export fmi3Status fmi3GetInt16(fmi3Instance instance, const fmi3ValueReference vr[], size_t nvr, fmi3Int16 values[], size_t n_values)
+{
+  return fmi3Error;
+}
+
+FMI3_Export fmi3Status fmi3GetUInt16(fmi3Instance instance, const fmi3ValueReference vr[], size_t nvr, fmi3UInt16 values[], size_t n_values)
+{
+  return fmi3Error;
+}
+
+FMI3_Export fmi3Status fmi3GetInt32(fmi3Instance instance, const fmi3ValueReference vr[], size_t nvr, fmi3Int32 values[], size_t n_values)
+{
+  auto* myc = (OSIFieldCheckerFmi3*)instance;
+  return myc->GetInt32(vr, nvr, values, n_values);
+}
+
+FMI3_Export fmi3Status fmi3GetUInt32(fmi3Instance instance, const fmi3ValueReference vr[], size_t nvr, fmi3UInt32 values[], size_t n_values)
+{
+  return fmi3Error;
+}
+
+FMI3_Export fmi3Status fmi3GetInt64(fmi3Instance instance, const fmi3ValueReference vr[], size_t nvr, fmi3Int64 values[], size_t n_values)
+{
+  return fmi3Error;
+}
+
+FMI3_Export fmi3Status fmi3GetUInt64(fmi3Instance instance, const fmi3ValueReference vr[], size_t nvr, fmi3UInt64 values[], size_t n_values)
+{
+  return fmi3Error;
+}
+
+FMI3_Export fmi3Status fmi3GetBoolean(fmi3Instance instance, const fmi3ValueReference vr[], size_t nvr, fmi3Boolean values[], size_t n_values)
+{
+  auto* myc = (OSIFieldCheckerFmi3*)instance;
+  return myc->GetBoolean(vr, nvr, values, n_values);
+}
+
+FMI3_Export fmi3Status fmi3GetString(fmi3Instance instance, const fmi3ValueReference vr[], size_t nvr, fmi3String values[], size_t n_values)
+{
+  auto* myc = (OSIFieldCheckerFmi3*)instance;
+  return myc->GetString(vr, nvr, values, n_values);
+}
+
+FMI3_Export fmi3Status fmi3GetBinary(fmi3Instance instance, const fmi3ValueReference vr[], size_t nvr, size_t value_sizes[], fmi3Binary values[], size_t n_values)
+{
+  auto* myc = (OSIFieldCheckerFmi3*)instance;
+  return myc->GetBinary(vr, nvr, value_sizes, values, n_values);
+}
+
+FMI3_Export fmi3Status fmi3GetClock(fmi3Instance instance, const fmi3ValueReference vr[], size_t nvr, fmi3Clock values[])
+{
+  auto* myc = (OSIFieldCheckerFmi3*)instance;
+  return myc->GetClock(vr, nvr, values);
+}
+
+FMI3_Export fmi3Status fmi3SetFloat32(fmi3Instance instance, const fmi3ValueReference vr[], size_t nvr, const fmi3Float32 values[], size_t n_values)
+{
+  return fmi3Error;
+}
+
+FMI3_Export fmi3Status fmi3SetFloat64(fmi3Instance instance, const fmi3ValueReference vr[], size_t nvr, const fmi3Float64 values[], size_t n_values)
+{
+  auto* myc = (OSIFieldCheckerFmi3*)instance;
+  return myc->SetFloat64(vr, nvr, values, n_values);
+}
+
+FMI3_Export fmi3Status fmi3SetInt8(fmi3Instance instance, const fmi3ValueReference vr[], size_t nvr, const fmi3Int8 values[], size_t n_values)
+{
+  return fmi3Error;
+}
+
+FMI3_Export fmi3Status fmi3SetUInt8(fmi3Instance instance, const fmi3ValueReference vr[], size_t nvr, const fmi3UInt8 values[], size_t n_values)
+{
+  return fmi3Error;
+}
+
+FMI3_Export fmi3Status fmi3SetInt16(fmi3Instance instance, const fmi3ValueReference vr[], size_t nvr, const fmi3Int16 values[], size_t n_values)
+{
+  return fmi3Error;
+}
+
+FMI3_Export fmi3Status fmi3SetUInt16(fmi3Instance instance, const fmi3ValueReference vr[], size_t nvr, const fmi3UInt16 values[], size_t n_values)
+{
+  return fmi3Error;
+}
+
+FMI3_Export fmi3Status fmi3SetInt32(fmi3Instance instance, const fmi3ValueReference vr[], size_t nvr, const fmi3Int32 values[], size_t n_values)
+{
+  auto* myc = (OSIFieldCheckerFmi3*)instance;
+  return myc->SetInt32(vr, nvr, values, n_values);
+}
+
+FMI3_Export fmi3Status fmi3SetUInt32(fmi3Instance instance, const fmi3ValueReference vr[], size_t nvr, const fmi3UInt32 values[], size_t n_values)
+{
+  return fmi3Error;
+}
+
+FMI3_Export fmi3Status fmi3SetInt64(fmi3Instance instance, const fmi3ValueReference vr[], size_t nvr, const fmi3Int64 values[], size_t n_values)
+{
+  return fmi3Error;
+}
+
+FMI3_Export fmi3Status fmi3SetUInt64(fmi3Instance instance, const fmi3ValueReference vr[], size_t nvr, const fmi3UInt64 values[], size_t n_values)
+{
+  return fmi3Error;
+}
+
+FMI3_Export fmi3Status fmi3SetBoolean(fmi3Instance instance, const fmi3ValueReference vr[], size_t nvr, const fmi3Boolean values[], size_t n_values)
+{
+  auto* myc = (OSIFieldCheckerFmi3*)instance;
+  return myc->SetBoolean(vr, nvr, values, n_values);
+}
+
+FMI3_Export fmi3Status fmi3SetString(fmi3Instance instance, const fmi3ValueReference vr[], size_t nvr, const fmi3String values[], size_t n_values)
+{
+  auto* myc = (OSIFieldCheckerFmi3*)instance;
+  return myc->SetString(vr, nvr, values, n_values);
+}
+
+FMI3_Export fmi3Status fmi3SetBinary(fmi3Instance instance, const fmi3ValueReference vr[], size_t nvr, const size_t value_sizes[], const fmi3Binary values[], size_t n_values)
+{
+  auto* myc = (OSIFieldCheckerFmi3*)instance;
+  return myc->SetBinary(vr, nvr, value_sizes, values, n_values);
+}
+
+FMI3_Export fmi3Status fmi3SetClock(fmi3Instance instance, const fmi3ValueReference vr[], size_t nvr, const fmi3Clock values[])
+{
+  auto* myc = (OSIFieldCheckerFmi3*)instance;
+  return myc->SetClock(vr, nvr, values);
+}
+
+/*
+ * Getting Variable Dependency Information
+ */
+FMI3_Export fmi3Status fmi3GetNumberOfVariableDependencies(fmi3Instance instance, fmi3ValueReference vr, size_t* n_dependencies)
+{
+  return fmi3Error;
+}
+
+FMI3_Export fmi3Status fmi3GetVariableDependencies(fmi3Instance instance,
+                                                   fmi3ValueReference dependent,
+                                                   size_t element_indices_of_dependent[],
+                                                   fmi3ValueReference independents[],
+                                                   size_t element_indices_of_independents[],
+                                                   fmi3DependencyKind dependency_kinds[],
+                                                   size_t n_dependencies)
+{
+  return fmi3Error;
+}
+
+/*
+ * Getting and setting the internal FMU state
+ */
+FMI3_Export fmi3Status fmi3GetFMUState(fmi3Instance instance, fmi3FMUState* fmu_state)
+{
+  return fmi3Error;
+}
+
+FMI3_Export fmi3Status fmi3SetFMUState(fmi3Instance instance, fmi3FMUState fmu_state)
+{
+  return fmi3Error;
+}
+
+FMI3_Export fmi3Status fmi3FreeFMUState(fmi3Instance instance, fmi3FMUState* fmu_state)
+{
+  return fmi3Error;
+}
+
+FMI3_Export fmi3Status fmi3SerializedFMUStateSize(fmi3Instance instance, fmi3FMUState fmu_state, size_t* size)
+{
+  return fmi3Error;
+}
+
+FMI3_Export fmi3Status fmi3SerializeFMUState(fmi3Instance instance, fmi3FMUState fmu_state, fmi3Byte serialized_state[], size_t size)
+{
+  return fmi3Error;
+}
+
+FMI3_Export fmi3Status fmi3DeserializeFMUState(fmi3Instance instance, const fmi3Byte serialized_state[], size_t size, fmi3FMUState* fmu_state)
+{
+  return fmi3Error;
+}
+
+/*
+ * Getting partial derivatives
+ */
+FMI3_Export fmi3Status fmi3GetDirectionalDerivative(fmi3Instance instance,
+                                                    const fmi3ValueReference unknowns[],
+                                                    size_t n_unknowns,
+                                                    const fmi3ValueReference knowns[],
+                                                    size_t n_knowns,
+                                                    const fmi3Float64 seed[],
+                                                    size_t n_seed,
+                                                    fmi3Float64 sensitivity[],
+                                                    size_t n_sensitivity)
+{
+  return fmi3Error;
+}
+
+FMI3_Export fmi3Status fmi3GetAdjointDerivative(fmi3Instance instance,
+                                                const fmi3ValueReference unknowns[],
+                                                size_t n_unknowns,
+                                                const fmi3ValueReference knowns[],
+                                                size_t n_knowns,
+                                                const fmi3Float64 seed[],
+                                                size_t n_seed,
+                                                fmi3Float64 sensitivity[],
+                                                size_t n_sensitivity)
+{
+  return fmi3Error;
+}
+
+/*
+ * Entering and exiting the Configuration or Reconfiguration Mode
+ */
+FMI3_Export fmi3Status fmi3EnterConfigurationMode(fmi3Instance instance)
+{
+  return fmi3Error;
+}
+
+FMI3_Export fmi3Status fmi3ExitConfigurationMode(fmi3Instance instance)
+{
+  return fmi3Error;
+}
+
+/*
+ * Clock related functions, both clocks are triggered and have no interval
+ */
+FMI3_Export fmi3Status fmi3GetIntervalDecimal(fmi3Instance instance, const fmi3ValueReference vr[], size_t nvr, fmi3Float64 intervals[], fmi3IntervalQualifier qualifiers[])
+{
+  return fmi3Error;
+}
+
+FMI3_Export fmi3Status fmi3GetIntervalFraction(fmi3Instance instance,
+                                               const fmi3ValueReference vr[],
+                                               size_t nvr,
+                                               fmi3UInt64 counters[],
+                                               fmi3UInt64 resolutions[],
+                                               fmi3IntervalQualifier qualifiers[])
+{
+  return fmi3Error;
+}
+
+FMI3_Export fmi3Status fmi3GetShiftDecimal(fmi3Instance instance, const fmi3ValueReference vr[], size_t nvr, fmi3Float64 shifts[])
+{
+  return fmi3Error;
+}
+
+FMI3_Export fmi3Status fmi3GetShiftFraction(fmi3Instance instance, const fmi3ValueReference vr[], size_t nvr, fmi3UInt64 counters[], fmi3UInt64 resolutions[])
+{
+  return fmi3Error;
+}
+
+FMI3_Export fmi3Status fmi3SetIntervalDecimal(fmi3Instance instance, const fmi3ValueReference vr[], size_t nvr, const fmi3Float64 intervals[])
+{
+  return fmi3Error;
+}
+
+FMI3_Export fmi3Status fmi3SetIntervalFraction(fmi3Instance instance, const fmi3ValueReference vr[], size_t nvr, const fmi3UInt64 counters[], const fmi3UInt64 resolutions[])
+{
+  return fmi3Error;
+}
+
+FMI3_Export fmi3Status fmi3SetShiftDecimal(fmi3Instance instance, const fmi3ValueReference vr[], size_t nvr, const fmi3Float64 shifts[])
+{
+  return fmi3Error;
+}
+
+FMI3_Export fmi3Status fmi3SetShiftFraction(fmi3Instance instance, const fmi3ValueReference vr[], size_t nvr, const fmi3UInt64 counters[], const fmi3UInt64 resolutions[])
+{
+  return fmi3Error;
+}
+
+FMI3_Export fmi3Status fmi3EvaluateDiscreteStates(fmi3Instance instance)
+{
+  return fmi3OK;
+}
+
+FMI3_Export fmi3Status fmi3UpdateDiscreteStates(fmi3Instance instance,
+                                                fmi3Boolean* discrete_states_need_update,
+                                                fmi3Boolean* terminate_simulation,
+                                                fmi3Boolean* nominals_of_continuous_states_changed,
+                                                fmi3Boolean* values_of_continuous_states_changed,
+                                                fmi3Boolean* next_event_time_defined,
+                                                fmi3Float64* next_event_time)
+{
+  auto* myc = (OSIFieldCheckerFmi3*)instance;
+  return myc->UpdateDiscreteStates(discrete_states_need_update,
+                                   terminate_simulation,
+                                   nominals_of_continuous_states_changed,
+                                   values_of_continuous_states_changed,
+                                   next_event_time_defined,
+                                   next_event_time);
+}
+
+/*
+ * Functions for Model Exchange
+ */
+FMI3_Export fmi3Status fmi3EnterContinuousTimeMode(fmi3Instance instance)
+{
+  return fmi3Error;
+}
+
+FMI3_Export fmi3Status fmi3CompletedIntegratorStep(fmi3Instance instance,
+                                                   fmi3Boolean no_set_fmu_state_prior_to_current_point,
+                                                   fmi3Boolean* enter_event_mode,
+                                                   fmi3Boolean* terminate_simulation)
+{
+  return fmi3Error;
+}
+
+FMI3_Export fmi3Status fmi3SetTime(fmi3Instance instance, fmi3Float64 time)
+{
+  return fmi3Error;
+}
+
+FMI3_Export fmi3Status fmi3SetContinuousStates(fmi3Instance instance, const fmi3Float64 continuous_states[], size_t n_continuous_states)
+{
+  return fmi3Error;
+}
+
+FMI3_Export fmi3Status fmi3GetContinuousStateDerivatives(fmi3Instance instance, fmi3Float64 derivatives[], size_t n_continuous_states)
+{
+  return fmi3Error;
+}
+
+FMI3_Export fmi3Status fmi3GetEventIndicators(fmi3Instance instance, fmi3Float64 event_indicators[], size_t n_event_indicators)
+{
+  return fmi3Error;
+}
+
+FMI3_Export fmi3Status fmi3GetContinuousStates(fmi3Instance instance, fmi3Float64 continuous_states[], size_t n_continuous_states)
+{
+  return fmi3Error;
+}
+
+FMI3_Export fmi3Status fmi3GetNominalsOfContinuousStates(fmi3Instance instance, fmi3Float64 nominals[], size_t n_continuous_states)
+{
+  return fmi3Error;
+}
+
+FMI3_Export fmi3Status fmi3GetNumberOfEventIndicators(fmi3Instance instance, size_t* n_event_indicators)
+{
+  return fmi3Error;
+}
+
+FMI3_Export fmi3Status fmi3GetNumberOfContinuousStates(fmi3Instance instance, size_t* n_continuous_states)
+{
+  return fmi3Error;
+}
+
+/*
+ * Functions for Co-Simulation
+ */
+FMI3_Export fmi3Status fmi3EnterStepMode(fmi3Instance instance)
+{
+  auto* myc = (OSIFieldCheckerFmi3*)instance;
+  return myc->EnterStepMode();
+}
+
+FMI3_Export fmi3Status fmi3GetOutputDerivatives(fmi3Instance instance,
+                                                const fmi3ValueReference vr[],
+                                                size_t nvr,
+                                                const fmi3Int32 orders[],
+                                                fmi3Float64 values[],
+                                                size_t n_values)
+{
+  return fmi3Error;
+}
+
+FMI3_Export fmi3Status fmi3DoStep(fmi3Instance instance,
+                                  fmi3Float64 current_communication_point,
+                                  fmi3Float64 communication_step_size,
+                                  fmi3Boolean no_set_fmu_state_prior_to_current_point,
+                                  fmi3Boolean* event_handling_needed,
+                                  fmi3Boolean* terminate_simulation,
+                                  fmi3Boolean* early_return,
+                                  fmi3Float64* last_successful_time)
+{
+  auto* myc = (OSIFieldCheckerFmi3*)instance;
+  return myc->DoStep(current_communication_point,
+                     communication_step_size,
+                     no_set_fmu_state_prior_to_current_point,
+                     event_handling_needed,
+                     terminate_simulation,
+                     early_return,
+                     last_successful_time);
+}
+
+/*
+ * Functions for Scheduled Execution
+ */
+FMI3_Export fmi3Status fmi3ActivateModelPartition(fmi3Instance instance, fmi3ValueReference clock_reference, fmi3Float64 activation_time)
+{
+  return fmi3Error;
+}
+}
@@ -0,0 +1,122 @@
+//
+// Copyright 2023 BMW AG
+// SPDX-License-Identifier: MPL-2.0
+//
+
+#pragma once
+
+#include "fmi3Functions.h"
+
+#include "OSIFieldChecker.h"
+
+/*
+ * FMI 3.0 Co-Simulation Variant
+ *
+ * The same checker as the FMI 2.0 FMU, with the OSMP pointer/size integer
+ * triples replaced by fmi3Binary variables.  The input binaries are clocked
+ * by OSMPSensorDataInClock, a frame is checked in the event in which the
+ * clock ticks (or, without event mode, in the next fmi3DoStep after the
+ * binary was set), and OSMPSensorDataOutClock ticks when the checked frame
+ * is available at OSMPSensorDataOut.  Steps without a new frame do no work.
+ *
+ * Value references of the scalar variables are the FMI 2.0 indices plus the
+ * offset of their type, the field statistics arrays start at the value
+ * reference of their first element.
+ */
+
+#define FMI3_VR_SENSORDATA_IN 0
+#define FMI3_VR_SENSORDATA_OUT 1
+#define FMI3_VR_SENSORDATA_IN_CLOCK 2
+#define FMI3_VR_SENSORDATA_OUT_CLOCK 3
+#define FMI3_VR_SENSORDATA_BATCH_IN 4
+#define FMI3_VR_SENSORVIEW_IN 5
+#define FMI3_VR_BOOLEAN_OFFSET 100
+#define FMI3_VR_INT32_OFFSET 200
+#define FMI3_VR_FLOAT64_OFFSET 400
+#define FMI3_VR_STRING_OFFSET 500
+
+/* Forwards messages of the FMI 2.0 logger interface used by OSIFieldChecker to the FMI 3.0 callback */
+struct Fmi3LogForwarder
+{
+  Fmi3LogForwarder(fmi3InstanceEnvironment theinstance_environment, fmi3LogMessageCallback thelog_message);
+  static void LogMessage(fmi2ComponentEnvironment component_environment, fmi2String instance_name, fmi2Status status, fmi2String category, fmi2String message, ...);
+
+  fmi3InstanceEnvironment instance_environment;
+  fmi3LogMessageCallback log_message;
+  fmi2CallbackFunctions functions;
+};
+
+/* Declared before OSIFieldChecker, so the callbacks exist when the checker copies them */
+class OSIFieldCheckerFmi3 : private Fmi3LogForwarder, public OSIFieldChecker
+{
+public:
+  /* FMI3 Interface mapped to C++ */
+  OSIFieldCheckerFmi3(fmi3String theinstance_name,
+                      fmi3String theinstantiation_token,
+                      fmi3String theresource_path,
+                      fmi3Boolean thevisible,
+                      fmi3Boolean thelogging_on,
+                      fmi3Boolean theevent_mode_used,
+                      fmi3InstanceEnvironment theinstance_environment,
+                      fmi3LogMessageCallback thelog_message);
+  static fmi3Instance Instantiate(fmi3String instance_name,
+                                  fmi3String instantiation_token,
+                                  fmi3String resource_path,
+                                  fmi3Boolean visible,
+                                  fmi3Boolean logging_on,
+                                  fmi3Boolean event_mode_used,
+                                  fmi3Boolean early_return_allowed,
+                                  const fmi3ValueReference required_intermediate_variables[],
+                                  size_t n_required_intermediate_variables,
+                                  fmi3InstanceEnvironment instance_environment,
+                                  fmi3LogMessageCallback log_message,
+                                  fmi3IntermediateUpdateCallback intermediate_update);
+  fmi3Status EnterInitializationMode(fmi3Float64 start_time);
+  fmi3Status ExitInitializationMode();
+  fmi3Status EnterEventMode();
+  fmi3Status UpdateDiscreteStates(fmi3Boolean* discrete_states_need_update,
+                                  fmi3Boolean* terminate_simulation,
+                                  fmi3Boolean* nominals_of_continuous_states_changed,
+                                  fmi3Boolean* values_of_continuous_states_changed,
+                                  fmi3Boolean* next_event_time_defined,
+                                  fmi3Float64* next_event_time);
+  fmi3Status EnterStepMode();
+  fmi3Status DoStep(fmi3Float64 current_communication_point,
+                    fmi3Float64 communication_step_size,
+                    fmi3Boolean no_set_fmu_state_prior_to_current_point,
+                    fmi3Boolean* event_handling_needed,
+                    fmi3Boolean* terminate_simulation,
+                    fmi3Boolean* early_return,
+                    fmi3Float64* last_successful_time);
+  fmi3Status Terminate();
+  fmi3Status Reset();
+  fmi3Status GetFloat64(const fmi3ValueReference vr[], size_t nvr, fmi3Float64 values[], size_t n_values);
+  fmi3Status GetInt32(const fmi3ValueReference vr[], size_t nvr, fmi3Int32 values[], size_t n_values);
+  fmi3Status GetBoolean(const fmi3ValueReference vr[], size_t nvr, fmi3Boolean values[], size_t n_values);
+  fmi3Status GetString(const fmi3ValueReference vr[], size_t nvr, fmi3String values[], size_t n_values);
+  fmi3Status GetBinary(const fmi3ValueReference vr[], size_t nvr, size_t value_sizes[], fmi3Binary values[], size_t n_values);
+  fmi3Status GetClock(const fmi3ValueReference vr[], size_t nvr, fmi3Clock values[]);
+  fmi3Status SetFloat64(const fmi3ValueReference vr[], size_t nvr, const fmi3Float64 values[], size_t n_values);
+  fmi3Status SetInt32(const fmi3ValueReference vr[], size_t nvr, const fmi3Int32 values[], size_t n_values);
+  fmi3Status SetBoolean(const fmi3ValueReference vr[], size_t nvr, const fmi3Boolean values[], size_t n_values);
+  fmi3Status SetString(const fmi3ValueReference vr[], size_t nvr, const fmi3String values[], size_t n_values);
+  fmi3Status SetBinary(const fmi3ValueReference vr[], size_t nvr, const size_t value_sizes[], const fmi3Binary values[], size_t n_values);
+  fmi3Status SetClock(const fmi3ValueReference vr[], size_t nvr, const fmi3Clock values[]);
+
+protected:
+  void CheckNewFrame(fmi3Float64 current_communication_point);
+  /* The copies of the binary inputs count against the memory budget */
+  size_t VariantMemoryUsage() const override;
+  void ReleaseVariantBuffers() override;
+  void SetFmiBinaryIn(int baselo_idx, int basehi_idx, int size_idx, string& buffer, const fmi3Binary value, size_t size);
+
+  /* Members */
+  bool event_mode_used_;
+  fmi3Float64 current_time_ = 0.0;
+  bool new_frame_ = false;           // without event mode, set by the input binaries, since the input clock cannot tick
+  bool input_clock_active_ = false;  // in event mode, latched by fmi3SetClock until the frame is checked or the event ends
+  bool output_clock_active_ = false;
+  string sensor_data_in_buffer_;  // FMI 3.0 binaries are only valid during fmi3SetBinary, so the frame is copied once
+  string sensor_data_batch_in_buffer_;
+  string sensor_view_in_buffer_;
+};
@@ -0,0 +1,236 @@
+//
+// Copyright 2023 BMW AG
+// SPDX-License-Identifier: MPL-2.0
+//
+
+/*
+ * Python Bindings
+ *
+ * The module osi_field_checker runs the field checks of the FMU on
+ * serialized SensorData held by Python buffers (bytes, memoryview, numpy
+ * arrays).  Buffers are read in place and the GIL is released while
+ * checking, so frames can be checked on all cores, either from Python
+ * threads or with the threads argument.  Counts are returned as numpy
+ * arrays with one column per field check in the order of field_names, and
+ * report() turns them into the verdicts the FMU reports at fmi2Terminate.
+ */
+
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "CheckProfile.h"
+#include "FieldChecks.h"
+#include "TraceChecks.h"
+
+namespace py = pybind11;
+
+namespace
+{
+
+/* Counts given as any array-like are converted to a C-contiguous uint64 array */
+typedef py::array_t<uint64_t, py::array::c_style | py::array::forcecast> CountArray;
+
+const py::ssize_t kFieldCount = kFieldCheckCount;
+
+/*
+ * Buffers of Python objects, they are released with the list.  The
+ * capacity is reserved up front, so the frames keep pointing into buffers
+ * that are not moved.
+ */
+class BufferList
+{
+public:
+  explicit BufferList(size_t capacity) { buffers_.reserve(capacity); }
+
+  /* Memory of a C-contiguous buffer, it stays valid as long as the list */
+  TraceFrame AddContiguous(const py::buffer& object)
+  {
+    buffers_.push_back(object.request());
+    const py::buffer_info& buffer = buffers_.back();
+    py::ssize_t stride = buffer.itemsize;
+    for (py::ssize_t dimension = buffer.ndim - 1; dimension >= 0; dimension--)
+    {
+      if (buffer.shape[dimension] > 1 && buffer.strides[dimension] != stride)
+      {
+        throw py::value_error("buffer has to be contiguous");
+      }
+      stride *= buffer.shape[dimension];
+    }
+    return {buffer.ptr, static_cast<size_t>(buffer.size * buffer.itemsize)};
+  }
+
+private:
+  std::vector<py::buffer_info> buffers_;
+};
+
+size_t ThreadCount(py::ssize_t threads)
+{
+  if (threads < 1)
+  {
+    throw py::value_error("threads has to be at least 1");
+  }
+  return static_cast<size_t>(threads);
+}
+
+class FieldChecker
+{
+public:
+  explicit FieldChecker(const std::string& check_file)
+  {
+    std::string error;
+    profile_ = CheckProfile::Load(check_file, error);
+    if (!profile_)
+    {
+      throw std::runtime_error("OSI check file not found! (" + error + ")");
+    }
+  }
+
+  py::array_t<bool> Enabled() const
+  {
+    py::array_t<bool> enabled(kFieldCount);
+    bool* data = enabled.mutable_data();
+    for (int i = 0; i < kFieldCheckCount; i++)
+    {
+      data[i] = (profile_->EnabledChecks() & FieldCheckBit(static_cast<FieldCheck>(i))) != 0;
+    }
+    return enabled;
+  }
+
+  /* One serialized frame, counts have the shape (fields,) */
+  py::dict Check(const py::buffer& frame) const
+  {
+    BufferList buffers(1);
+    const std::vector<TraceFrame> frames(1, buffers.AddContiguous(frame));
+    return CheckSplitFrames(frames, 1, true);
+  }
+
+  /* Length-prefixed frames like a binary OSI trace file, counts have the shape (frames, fields) */
+  py::dict CheckTrace(const py::buffer& trace, py::ssize_t threads) const
+  {
+    const size_t thread_count = ThreadCount(threads);
+    BufferList buffers(1);
+    const TraceFrame bytes = buffers.AddContiguous(trace);
+    std::vector<TraceFrame> frames;
+    const bool complete = SplitTraceFrames(bytes.data, bytes.size, frames);
+    py::dict result = CheckSplitFrames(frames, thread_count, false);
+    result["truncated"] = !complete;
+    return result;
+  }
+
+  /* A sequence of buffers with one frame each, counts have the shape (frames, fields) */
+  py::dict CheckFrames(const py::sequence& sequence, py::ssize_t threads) const
+  {
+    const size_t thread_count = ThreadCount(threads);
+    const size_t frame_count = py::len(sequence);
+    BufferList buffers(frame_count);
+    std::vector<TraceFrame> frames;
+    frames.reserve(frame_count);
+    for (const py::handle item : sequence)
+    {
+      if (!py::isinstance<py::buffer>(item))
+      {
+        throw py::type_error("frames has to be a sequence of buffers");
+      }
+      frames.push_back(buffers.AddContiguous(py::reinterpret_borrow<py::buffer>(item)));
+    }
+    return CheckSplitFrames(frames, thread_count, false);
+  }
+
+private:
+  /* Checks with the GIL released, counts have the shape (frames, fields) or (fields,) for a single frame */
+  py::dict CheckSplitFrames(const std::vector<TraceFrame>& frames, size_t threads, bool single_frame) const
+  {
+    const auto frame_count = static_cast<py::ssize_t>(frames.size());
+    const std::vector<py::ssize_t> shape = single_frame ? std::vector<py::ssize_t>{kFieldCount} : std::vector<py::ssize_t>{frame_count, kFieldCount};
+    py::array_t<uint64_t> checked(shape);
+    py::array_t<uint64_t> missing(shape);
+    py::array_t<bool> parsed(frame_count);
+    uint64_t* checked_data = checked.mutable_data();
+    uint64_t* missing_data = missing.mutable_data();
+    auto* parsed_data = reinterpret_cast<uint8_t*>(parsed.mutable_data());
+    {
+      /* std::system_error if threads cannot be started, raised as RuntimeError once the GIL is held again */
+      py::gil_scoped_release release;
+      CheckTraceFrames(frames, profile_->EnabledChecks(), threads, checked_data, missing_data, parsed_data);
+    }
+
+    py::dict result;
+    result["checked"] = checked;
+    result["missing"] = missing;
+    if (single_frame)
+    {
+      result["parsed"] = parsed_data[0] != 0;
+    }
+    else
+    {
+      result["parsed"] = parsed;
+    }
+    return result;
+  }
+
+  std::shared_ptr<const CheckProfile> profile_;
+};
+
+/*
+ * Verdicts of the FMU for accumulated counts: fields with a fill rate below
+ * min_fill_rate are errors, other fields that were missing are warnings.
+ */
+std::vector<std::string> Report(const CountArray& checked, const CountArray& missing, double min_fill_rate)
+{
+  if (checked.ndim() < 1 || checked.ndim() > 2 || checked.shape(checked.ndim() - 1) != kFieldCount || missing.ndim() != checked.ndim() || missing.size() != checked.size())
+  {
+    throw py::value_error("checked and missing have to be counts of the shape (fields,) or (frames, fields)");
+  }
+  const py::ssize_t frame_count = checked.size() / kFieldCount;
+  FieldStatistics statistics;
+  for (py::ssize_t frame = 0; frame < frame_count; frame++)
+  {
+    FieldCounts counts;
+    for (int i = 0; i < kFieldCheckCount; i++)
+    {
+      counts.checked[i] = checked.data()[frame * kFieldCount + i];
+      counts.missing[i] = missing.data()[frame * kFieldCount + i];
+    }
+    statistics.Add(counts, ~FieldCheckMask(0));  // counts of disabled checks are already 0
+  }
+  return ReportFieldStatistics(statistics, min_fill_rate).lines;
+}
+
+}  // namespace
+
+PYBIND11_MODULE(osi_field_checker, module)
+{
+  module.doc() = "Field checks of the OSIFieldChecker FMU for serialized OSI SensorData";
+
+  py::list field_names;
+  for (int i = 0; i < kFieldCheckCount; i++)
+  {
+    field_names.append(kFieldCheckNames[i]);
+  }
+  module.attr("field_names") = field_names;
+  module.attr("osi_version") = OSI_VERSION;
+
+  py::class_<FieldChecker>(module, "FieldChecker", "Load a text check file or a compiled check profile")
+      .def(py::init<const std::string&>(), py::arg("check_file"))
+      .def_property_readonly("enabled", &FieldChecker::Enabled, "Field checks requested by the check file, in the order of field_names")
+      .def("check", &FieldChecker::Check, py::arg("frame"), "Check one serialized SensorData frame")
+      .def("check_trace",
+           &FieldChecker::CheckTrace,
+           py::arg("trace"),
+           py::arg("threads") = 1,
+           "Check the frames of a binary OSI trace, each preceded by its size as 32 bit little-endian integer")
+      .def("check_frames", &FieldChecker::CheckFrames, py::arg("frames"), py::arg("threads") = 1, "Check a sequence of serialized SensorData frames");
+
+  module.def("report",
+             &Report,
+             py::arg("checked"),
+             py::arg("missing"),
+             py::arg("min_fill_rate") = 1.0,
+             "Reports of the FMU at the end of a simulation for the given counts, errors fail the check");
+}
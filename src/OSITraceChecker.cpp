@@ -0,0 +1,220 @@
+//
+// Copyright 2023 BMW AG
+// SPDX-License-Identifier: MPL-2.0
+//
+
+/*
+ * Checks a recorded binary OSI trace of SensorData with the field checks of
+ * the OSIFieldChecker FMU
+ *
+ * The trace is read in two stages on separate threads: the reader thread
+ * reads and, for .osi.lz4 and .osi.zst traces, decompresses the stream
+ * into complete frames, the main thread parses and checks them.  Frames
+ * are handed over through a fixed pool of frame buffers, so the reader can
+ * run ahead by at most the pool size, the throughput is that of the slower
+ * stage and memory use does not depend on the length of the trace.
+ *
+ * Reports are the same as those of the FMU at the end of a simulation, the
+ * exit code is 1 if a field has a fill rate below min_fill_rate (default 1)
+ * or the trace could not be read completely.
+ *
+ * Usage: OSITraceChecker <osi_check.txt> <trace.osi[.lz4|.zst]> [min_fill_rate]
+ */
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CheckProfile.h"
+#include "FieldChecks.h"
+#include "TraceStream.h"
+
+namespace
+{
+
+const size_t kQueueFrames = 16;
+
+/*
+ * Bounded hand-over of frames between the reader and the checking thread.
+ * Buffers circulate between the free and the filled queue and keep their
+ * allocation, the reader blocks while all buffers wait to be checked.
+ */
+class FrameQueue
+{
+public:
+  explicit FrameQueue(size_t frame_count) : frames_(frame_count)
+  {
+    for (auto& frame : frames_)
+    {
+      free_.push_back(&frame);
+    }
+  }
+
+  std::string* AcquireFree()
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    free_available_.wait(lock, [this] { return !free_.empty(); });
+    std::string* frame = free_.front();
+    free_.pop_front();
+    return frame;
+  }
+
+  void PushFilled(std::string* frame)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      filled_.push_back(frame);
+    }
+    filled_available_.notify_one();
+  }
+
+  /* No more frames will be pushed */
+  void Close()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      closed_ = true;
+    }
+    filled_available_.notify_one();
+  }
+
+  /* Next frame in trace order, nullptr once the queue is closed and all frames were taken */
+  std::string* PopFilled()
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    filled_available_.wait(lock, [this] { return !filled_.empty() || closed_; });
+    if (filled_.empty())
+    {
+      return nullptr;
+    }
+    std::string* frame = filled_.front();
+    filled_.pop_front();
+    return frame;
+  }
+
+  void Release(std::string* frame)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      free_.push_back(frame);
+    }
+    free_available_.notify_one();
+  }
+
+private:
+  std::vector<std::string> frames_;
+  std::deque<std::string*> free_;
+  std::deque<std::string*> filled_;
+  bool closed_ = false;
+  std::mutex mutex_;
+  std::condition_variable free_available_;
+  std::condition_variable filled_available_;
+};
+
+double Seconds(std::chrono::steady_clock::duration duration)
+{
+  return std::chrono::duration<double>(duration).count();
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  if (argc < 3 || argc > 4)
+  {
+    std::cerr << "Usage: " << argv[0] << " <osi_check.txt> <trace.osi[.lz4|.zst]> [min_fill_rate]" << std::endl;
+    return 2;
+  }
+  const double min_fill_rate = (argc == 4) ? std::atof(argv[3]) : 1.0;
+
+  std::string error;
+  std::shared_ptr<const CheckProfile> profile = CheckProfile::Load(argv[1], error);
+  if (!profile)
+  {
+    std::cerr << "OSI check file not found! (" << error << ")" << std::endl;
+    return 1;
+  }
+  const FieldCheckMask enabled_checks = profile->EnabledChecks();
+
+  TraceStream trace;
+  if (!trace.Open(argv[2], error))
+  {
+    std::cerr << error << std::endl;
+    return 1;
+  }
+
+  /* Reader stage */
+  FrameQueue queue(kQueueFrames);
+  std::chrono::steady_clock::duration read_time{};
+  std::thread reader([&trace, &queue, &read_time] {
+    for (;;)
+    {
+      std::string* frame = queue.AcquireFree();
+      const std::chrono::steady_clock::time_point read_start = std::chrono::steady_clock::now();
+      const bool complete = trace.ReadFrame(*frame);
+      read_time += std::chrono::steady_clock::now() - read_start;
+      if (!complete)
+      {
+        queue.Release(frame);
+        break;
+      }
+      queue.PushFilled(frame);
+    }
+    queue.Close();
+  });
+
+  /* Checking stage */
+  const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  std::chrono::steady_clock::duration check_time{};
+  osi3::SensorData sensor_data;  // reused for all frames
+  FieldStatistics statistics;
+  uint64_t frames_checked = 0;
+  uint64_t frames_unparsed = 0;
+  while (std::string* frame = queue.PopFilled())
+  {
+    const std::chrono::steady_clock::time_point check_start = std::chrono::steady_clock::now();
+    if (!sensor_data.ParseFromArray(frame->data(), static_cast<int>(frame->size())))
+    {
+      frames_unparsed++;  // checked as far as it was parsed, like in the FMU
+    }
+    queue.Release(frame);
+    FieldCounts counts;
+    CheckSensorDataFields(sensor_data, enabled_checks, counts);
+    statistics.Add(counts, enabled_checks);
+    frames_checked++;
+    check_time += std::chrono::steady_clock::now() - check_start;
+  }
+  reader.join();
+  const double elapsed = Seconds(std::chrono::steady_clock::now() - start);
+
+  const FieldReport report = ReportFieldStatistics(statistics, min_fill_rate);
+  for (const auto& line : report.lines)
+  {
+    std::cout << line << std::endl;
+  }
+  bool failed = report.failed;
+  if (frames_unparsed > 0)
+  {
+    std::cout << "::warning title=TraceChecker::" << frames_unparsed << " frames could not be parsed completely, they were checked as far as they were parsed" << std::endl;
+  }
+  if (!trace.Error().empty())
+  {
+    std::cout << "::error title=TraceChecker::" << argv[2] << ": " << trace.Error() << " after " << frames_checked << " frames" << std::endl;
+    failed = true;
+  }
+
+  const double megabytes = static_cast<double>(trace.TraceBytes()) / 1e6;
+  std::cout << std::fixed << std::setprecision(2) << "::notice title=TraceChecker::checked " << frames_checked << " frames (" << megabytes << " MB, "
+            << TraceStream::CompressionName(trace.GetCompression()) << " " << static_cast<double>(trace.FileBytes()) / 1e6 << " MB) in " << elapsed << " s ("
+            << (elapsed > 0.0 ? megabytes / elapsed : 0.0) << " MB/s), reading busy " << Seconds(read_time) << " s, checking busy " << Seconds(check_time) << " s"
+            << std::endl;
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,215 @@
+//
+// Copyright 2023 BMW AG
+// SPDX-License-Identifier: MPL-2.0
+//
+
+#include "ObjectRecall.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+namespace
+{
+
+/* Rotation into a coordinate system with the given orientation, the transpose of R = Rz(yaw) Ry(pitch) Rx(roll) */
+void InverseRotation(const osi3::Orientation3d& orientation, double rotation[3][3])
+{
+  const double cr = std::cos(orientation.roll());
+  const double sr = std::sin(orientation.roll());
+  const double cp = std::cos(orientation.pitch());
+  const double sp = std::sin(orientation.pitch());
+  const double cy = std::cos(orientation.yaw());
+  const double sy = std::sin(orientation.yaw());
+  rotation[0][0] = cy * cp;
+  rotation[0][1] = sy * cp;
+  rotation[0][2] = -sp;
+  rotation[1][0] = cy * sp * sr - sy * cr;
+  rotation[1][1] = sy * sp * sr + cy * cr;
+  rotation[1][2] = cp * sr;
+  rotation[2][0] = cy * sp * cr + sy * sr;
+  rotation[2][1] = sy * sp * cr - cy * sr;
+  rotation[2][2] = cp * cr;
+}
+
+void Rotate(const double rotation[3][3], const double in[3], double out[3])
+{
+  for (int row = 0; row < 3; row++)
+  {
+    out[row] = rotation[row][0] * in[0] + rotation[row][1] * in[1] + rotation[row][2] * in[2];
+  }
+}
+
+}  // namespace
+
+void GroundTruthIdSet::Clear(size_t expected_ids)
+{
+  size_t slot_count = 16;
+  while (slot_count < 2 * expected_ids)
+  {
+    slot_count <<= 1U;
+  }
+  generation_++;
+  if (slot_count > slots_.size() || generation_ == 0)
+  {
+    /* New or wrapped generation, all slots have to be marked unused */
+    slots_.assign(std::max(slot_count, slots_.size()), Slot{0, 0});
+    slot_mask_ = slots_.size() - 1;
+    generation_ = 1;
+  }
+}
+
+void GroundTruthIdSet::Insert(uint64_t id)
+{
+  for (size_t slot = static_cast<size_t>(HashId(id)) & slot_mask_;; slot = (slot + 1) & slot_mask_)
+  {
+    if (slots_[slot].generation != generation_)
+    {
+      slots_[slot].id = id;
+      slots_[slot].generation = generation_;
+      return;
+    }
+    if (slots_[slot].id == id)
+    {
+      return;
+    }
+  }
+}
+
+bool GroundTruthIdSet::Contains(uint64_t id) const
+{
+  for (size_t slot = static_cast<size_t>(HashId(id)) & slot_mask_;; slot = (slot + 1) & slot_mask_)
+  {
+    if (slots_[slot].generation != generation_)
+    {
+      return false;
+    }
+    if (slots_[slot].id == id)
+    {
+      return true;
+    }
+  }
+}
+
+void GroundTruthIdSet::Release()
+{
+  std::vector<Slot>().swap(slots_);
+  slot_mask_ = 0;
+  generation_ = 0;
+}
+
+void ObjectRecallChecker::Reset()
+{
+  missed_ids_.clear();
+  in_range_ = 0;
+  statistics_ = Statistics();
+}
+
+void ObjectRecallChecker::Release()
+{
+  detected_ids_.Release();
+  std::vector<uint64_t>().swap(missed_ids_);
+  in_range_ = 0;
+}
+
+void ObjectRecallChecker::Check(const osi3::SensorView& sensor_view, const osi3::SensorData& sensor_data, const RecallRegion& region)
+{
+  size_t detected_id_count = 0;
+  for (const auto& moving_object : sensor_data.moving_object())
+  {
+    detected_id_count += moving_object.header().ground_truth_id_size();
+  }
+  detected_ids_.Clear(detected_id_count);
+  for (const auto& moving_object : sensor_data.moving_object())
+  {
+    for (const auto& ground_truth_id : moving_object.header().ground_truth_id())
+    {
+      detected_ids_.Insert(ground_truth_id.value());
+    }
+  }
+
+  /* The region is placed by the host vehicle, without a host vehicle in the ground truth all objects are in range */
+  const osi3::GroundTruth& ground_truth = sensor_view.global_ground_truth();
+  const bool has_host = ground_truth.has_host_vehicle_id();
+  const uint64_t host_id = ground_truth.host_vehicle_id().value();
+  const osi3::MovingObject* host = nullptr;
+  if (has_host)
+  {
+    for (const auto& moving_object : ground_truth.moving_object())
+    {
+      if (moving_object.id().value() == host_id)
+      {
+        host = &moving_object;
+        break;
+      }
+    }
+  }
+  const bool limited = region.range > 0.0 || region.fov_horizontal > 0.0 || region.fov_vertical > 0.0;
+  double host_rotation[3][3];
+  double sensor_rotation[3][3];
+  double sensor_origin[3] = {};  // mounting position relative to the bounding box center of the host, in vehicle coordinates
+  if (host != nullptr && limited)
+  {
+    const osi3::MountingPosition& mounting_position = sensor_view.has_mounting_position() ? sensor_view.mounting_position() : sensor_data.mounting_position();
+    const osi3::Vector3d& bbcenter_to_rear = host->vehicle_attributes().bbcenter_to_rear();
+    InverseRotation(host->base().orientation(), host_rotation);
+    InverseRotation(mounting_position.orientation(), sensor_rotation);
+    sensor_origin[0] = bbcenter_to_rear.x() + mounting_position.position().x();
+    sensor_origin[1] = bbcenter_to_rear.y() + mounting_position.position().y();
+    sensor_origin[2] = bbcenter_to_rear.z() + mounting_position.position().z();
+  }
+  const double range_squared = region.range * region.range;
+
+  missed_ids_.clear();
+  in_range_ = 0;
+  for (const auto& moving_object : ground_truth.moving_object())
+  {
+    const uint64_t id = moving_object.id().value();
+    if (has_host && id == host_id)
+    {
+      continue;
+    }
+    if (host != nullptr && limited)
+    {
+      const osi3::Vector3d& position = moving_object.base().position();
+      const double global_offset[3] = {position.x() - host->base().position().x(), position.y() - host->base().position().y(),
+                                       position.z() - host->base().position().z()};
+      double vehicle[3];
+      Rotate(host_rotation, global_offset, vehicle);
+      const double vehicle_offset[3] = {vehicle[0] - sensor_origin[0], vehicle[1] - sensor_origin[1], vehicle[2] - sensor_origin[2]};
+      double sensor[3];
+      Rotate(sensor_rotation, vehicle_offset, sensor);
+
+      const double horizontal_squared = sensor[0] * sensor[0] + sensor[1] * sensor[1];
+      if ((region.range > 0.0 && horizontal_squared + sensor[2] * sensor[2] > range_squared) ||
+          (region.fov_horizontal > 0.0 && std::fabs(std::atan2(sensor[1], sensor[0])) > 0.5 * region.fov_horizontal) ||
+          (region.fov_vertical > 0.0 && std::fabs(std::atan2(sensor[2], std::sqrt(horizontal_squared))) > 0.5 * region.fov_vertical))
+      {
+        continue;
+      }
+    }
+    in_range_++;
+    if (!detected_ids_.Contains(id))
+    {
+      missed_ids_.push_back(id);
+    }
+  }
+
+  statistics_.frames++;
+  statistics_.objects_in_range += in_range_;
+  statistics_.objects_matched += in_range_ - missed_ids_.size();
+  if (!missed_ids_.empty())
+  {
+    statistics_.frames_with_missed_objects++;
+  }
+}
+
+std::string DescribeObjectRecall(const ObjectRecallChecker& checker)
+{
+  const ObjectRecallChecker::Statistics& statistics = checker.GetStatistics();
+  std::ostringstream description;
+  description << "missed " << statistics.objects_in_range - statistics.objects_matched << " of " << statistics.objects_in_range << " moving objects in range (recall "
+              << std::fixed << std::setprecision(2) << 100.0 * checker.TotalRecall() << " %) in " << statistics.frames_with_missed_objects << " frames";
+  return description.str();
+}
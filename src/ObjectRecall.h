@@ -0,0 +1,109 @@
+//
+// Copyright 2023 BMW AG
+// SPDX-License-Identifier: MPL-2.0
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "TemporalConsistency.h"
+#include "osi_sensordata.pb.h"
+#include "osi_sensorview.pb.h"
+
+/*
+ * Object recall between SensorView input and SensorData output
+ *
+ * Every moving object of the ground truth within the region covered by the
+ * sensor has to be detected, i.e. a moving object of the SensorData has to
+ * carry its id as ground_truth_id.  The region is given by a range and
+ * optional horizontal and vertical opening angles around the x axis of the
+ * sensor; object positions are transformed from global coordinates into
+ * the vehicle coordinate system of the host vehicle (origin at the rear
+ * axle) and from there into the sensor coordinate system given by the
+ * mounting_position.  The ground truth ids of the detected objects
+ * are inserted into an open-addressing hash set, then every ground truth
+ * object in range is looked up, so a frame is checked in linear time.  The
+ * set marks its slots with a generation counter instead of clearing them,
+ * and only grows, so no memory is allocated once the largest frame was seen.
+ */
+
+/* Check file entry enabling the recall check */
+constexpr const char* kCheckObjectRecall = "sensorview.moving_object.ground_truth_id";
+
+class GroundTruthIdSet
+{
+public:
+  /* Start a new frame, the table is grown to keep the load factor below 1/2 for the expected number of ids */
+  void Clear(size_t expected_ids);
+  void Insert(uint64_t id);
+  bool Contains(uint64_t id) const;
+  /* Free the table, it is allocated again by the next Clear() */
+  void Release();
+  size_t MemoryUsage() const { return slots_.capacity() * sizeof(Slot); }
+
+private:
+  struct Slot
+  {
+    uint64_t id;
+    uint32_t generation;  // slot is used in the current frame if it matches generation_
+  };
+
+  std::vector<Slot> slots_;
+  size_t slot_mask_ = 0;
+  uint32_t generation_ = 0;
+};
+
+/* Region in which ground truth objects have to be detected, limits <= 0 do not apply */
+struct RecallRegion
+{
+  double range = 0.0;
+  double fov_horizontal = 0.0;  // full opening angles in rad, symmetric to the x axis of the sensor
+  double fov_vertical = 0.0;
+};
+
+class ObjectRecallChecker
+{
+public:
+  struct Statistics
+  {
+    uint64_t frames = 0;
+    uint64_t frames_with_missed_objects = 0;
+    uint64_t objects_in_range = 0;
+    uint64_t objects_matched = 0;
+  };
+
+  void Reset();
+  /*
+   * Match the ground truth objects within region of the sensor against the
+   * detected objects.  The mounting_position of the SensorView is used, or
+   * that of the SensorData if the SensorView has none.
+   */
+  void Check(const osi3::SensorView& sensor_view, const osi3::SensorData& sensor_data, const RecallRegion& region);
+
+  /* Results of the last frame */
+  size_t InRange() const { return in_range_; }
+  const std::vector<uint64_t>& MissedIds() const { return missed_ids_; }
+  double Recall() const { return (in_range_ == 0) ? 1.0 : static_cast<double>(in_range_ - missed_ids_.size()) / static_cast<double>(in_range_); }
+
+  const Statistics& GetStatistics() const { return statistics_; }
+  /* Free the buffers reused between frames, the statistics are kept */
+  void Release();
+  size_t MemoryUsage() const { return detected_ids_.MemoryUsage() + missed_ids_.capacity() * sizeof(uint64_t); }
+  double TotalRecall() const
+  {
+    return (statistics_.objects_in_range == 0) ? 1.0 : static_cast<double>(statistics_.objects_matched) / static_cast<double>(statistics_.objects_in_range);
+  }
+
+private:
+  GroundTruthIdSet detected_ids_;
+  std::vector<uint64_t> missed_ids_;
+  size_t in_range_ = 0;
+  Statistics statistics_;
+};
+
+/* Summary of the run for the report, e.g. "missed 12 of 4800 moving objects in range (recall 99.75 %) in 9 frames" */
+std::string DescribeObjectRecall(const ObjectRecallChecker& checker);
@@ -0,0 +1,290 @@
+//
+// Copyright 2023 BMW AG
+// SPDX-License-Identifier: MPL-2.0
+//
+
+#include "TemporalConsistency.h"
+
+#include <algorithm>
+
+/*
+ * Tracking Id Table
+ */
+
+void TrackingIdTable::Init(size_t max_ids)
+{
+  max_ids = std::max<size_t>(max_ids, 1);
+  size_t slot_count = 1;
+  while (slot_count < 2 * max_ids)  // keep the load factor at or below 0.5
+  {
+    slot_count <<= 1U;
+  }
+  entries_.assign(max_ids, Track());
+  slots_.assign(slot_count, 0);
+  slot_mask_ = slot_count - 1;
+  Clear();
+}
+
+void TrackingIdTable::Clear()
+{
+  std::fill(slots_.begin(), slots_.end(), 0);
+  size_ = 0;
+  used_entries_ = 0;
+  free_head_ = kNil;
+  lru_head_ = kNil;
+  lru_tail_ = kNil;
+}
+
+TrackingIdTable::Track* TrackingIdTable::Find(uint64_t id)
+{
+  if (slots_.empty())
+  {
+    return nullptr;
+  }
+  for (size_t slot = HomeSlot(id); slots_[slot] != 0; slot = (slot + 1) & slot_mask_)
+  {
+    Track& track = entries_[slots_[slot] - 1];
+    if (track.id == id)
+    {
+      return &track;
+    }
+  }
+  return nullptr;
+}
+
+TrackingIdTable::Track* TrackingIdTable::Insert(uint64_t id, uint64_t frame, bool& evicted)
+{
+  evicted = false;
+  uint32_t index = 0;
+  if (free_head_ != kNil)
+  {
+    index = free_head_;
+    free_head_ = entries_[index].next;
+    size_++;
+  }
+  else if (used_entries_ < entries_.size())
+  {
+    index = static_cast<uint32_t>(used_entries_++);
+    size_++;
+  }
+  else
+  {
+    index = lru_tail_;
+    EraseSlot(entries_[index].id);
+    Unlink(index);
+    evicted = true;
+  }
+
+  Track& track = entries_[index];
+  track.id = id;
+  track.first_frame = frame;
+  track.last_frame = frame;
+  track.linked_id = 0;
+
+  size_t slot = HomeSlot(id);
+  while (slots_[slot] != 0)
+  {
+    slot = (slot + 1) & slot_mask_;
+  }
+  slots_[slot] = index + 1;
+  PushFront(index);
+  return &track;
+}
+
+void TrackingIdTable::Touch(Track* track)
+{
+  const auto index = static_cast<uint32_t>(track - entries_.data());
+  if (index != lru_head_)
+  {
+    Unlink(index);
+    PushFront(index);
+  }
+}
+
+void TrackingIdTable::Erase(Track* track)
+{
+  const auto index = static_cast<uint32_t>(track - entries_.data());
+  EraseSlot(track->id);
+  Unlink(index);
+  track->next = free_head_;
+  free_head_ = index;
+  size_--;
+}
+
+void TrackingIdTable::EraseSlot(uint64_t id)
+{
+  size_t hole = HomeSlot(id);
+  while (entries_[slots_[hole] - 1].id != id)
+  {
+    hole = (hole + 1) & slot_mask_;
+  }
+
+  /* Backward-shift deletion keeps probe sequences intact without tombstones */
+  size_t next = (hole + 1) & slot_mask_;
+  while (slots_[next] != 0)
+  {
+    const size_t home = HomeSlot(entries_[slots_[next] - 1].id);
+    if (((next - home) & slot_mask_) >= ((next - hole) & slot_mask_))
+    {
+      slots_[hole] = slots_[next];
+      hole = next;
+    }
+    next = (next + 1) & slot_mask_;
+  }
+  slots_[hole] = 0;
+}
+
+void TrackingIdTable::Unlink(uint32_t index)
+{
+  Track& track = entries_[index];
+  if (track.prev != kNil)
+  {
+    entries_[track.prev].next = track.next;
+  }
+  else
+  {
+    lru_head_ = track.next;
+  }
+  if (track.next != kNil)
+  {
+    entries_[track.next].prev = track.prev;
+  }
+  else
+  {
+    lru_tail_ = track.prev;
+  }
+}
+
+void TrackingIdTable::PushFront(uint32_t index)
+{
+  Track& track = entries_[index];
+  track.prev = kNil;
+  track.next = lru_head_;
+  if (lru_head_ != kNil)
+  {
+    entries_[lru_head_].prev = index;
+  }
+  lru_head_ = index;
+  if (lru_tail_ == kNil)
+  {
+    lru_tail_ = index;
+  }
+}
+
+/*
+ * Temporal Consistency Checker
+ */
+
+void TemporalConsistencyChecker::Configure(size_t max_tracked_ids, uint32_t max_absent_frames)
+{
+  if (table_.Capacity() != std::max<size_t>(max_tracked_ids, 1))
+  {
+    table_.Init(max_tracked_ids);  // keep the allocated tables when an instance is reused with the same size
+    ground_truth_table_.Init(max_tracked_ids);
+  }
+  max_absent_frames_ = max_absent_frames;
+  Reset();
+}
+
+void TemporalConsistencyChecker::Reset()
+{
+  table_.Clear();
+  ground_truth_table_.Clear();
+  frame_ = 0;
+  has_timestamp_ = false;
+  last_timestamp_ = 0.0;
+  statistics_ = Statistics();
+}
+
+bool TemporalConsistencyChecker::BeginFrame(double timestamp)
+{
+  frame_++;
+  statistics_.frames++;
+  const bool monotonic = !has_timestamp_ || timestamp > last_timestamp_;
+  if (!monotonic)
+  {
+    statistics_.timestamp_violations++;
+  }
+  has_timestamp_ = true;
+  last_timestamp_ = timestamp;
+  return monotonic;
+}
+
+void TemporalConsistencyChecker::BeginFrame()
+{
+  frame_++;
+  statistics_.frames++;
+}
+
+TemporalConsistencyChecker::ObjectResult TemporalConsistencyChecker::UpdateObject(uint64_t tracking_id,
+                                                                                   const uint64_t* ground_truth_id,
+                                                                                   uint64_t& previous_tracking_id,
+                                                                                   uint64_t& absent_frames)
+{
+  previous_tracking_id = 0;
+  absent_frames = 0;
+  ObjectResult result = kObjectPersistent;
+  TrackingIdTable::Track* track = table_.Find(tracking_id);
+  if (track == nullptr)
+  {
+    /* Evicting an id that left the sensor long ago is expected, evicting one that may still come back loses its history */
+    const TrackingIdTable::Track* oldest = (table_.Size() == table_.Capacity()) ? table_.Oldest() : nullptr;
+    const bool evicts_present_id = oldest != nullptr && frame_ - oldest->last_frame <= uint64_t(max_absent_frames_) + 1;
+    bool evicted = false;
+    table_.Insert(tracking_id, frame_, evicted);
+    if (evicted && evicts_present_id)
+    {
+      statistics_.evictions++;
+    }
+    result = kObjectNew;
+  }
+  else
+  {
+    table_.Touch(track);
+    if (track->last_frame == frame_)
+    {
+      statistics_.duplicate_ids++;
+      return kObjectDuplicate;
+    }
+    if (frame_ - track->last_frame - 1 > max_absent_frames_)
+    {
+      absent_frames = frame_ - track->last_frame - 1;
+      statistics_.gap_violations++;
+    }
+    track->last_frame = frame_;
+  }
+
+  if (ground_truth_id == nullptr)
+  {
+    return result;
+  }
+  TrackingIdTable::Track* object = ground_truth_table_.Find(*ground_truth_id);
+  if (object == nullptr)
+  {
+    bool evicted = false;
+    ground_truth_table_.Insert(*ground_truth_id, frame_, evicted)->linked_id = tracking_id;
+    return result;
+  }
+  ground_truth_table_.Touch(object);
+
+  /* A ground truth object split into several tracks of one frame is not an id change */
+  if (object->linked_id != tracking_id && object->last_frame != frame_)
+  {
+    previous_tracking_id = object->linked_id;
+    object->linked_id = tracking_id;
+    statistics_.id_changes++;
+    result = kObjectIdChanged;
+  }
+  object->last_frame = frame_;
+  return result;
+}
+
+void TemporalConsistencyChecker::EndFrame()
+{
+  /* The tail of the LRU list holds the ids seen least recently, so only ids to be removed are visited */
+  for (TrackingIdTable::Track* object = ground_truth_table_.Oldest(); object != nullptr && frame_ - object->last_frame > max_absent_frames_;
+       object = ground_truth_table_.Oldest())
+  {
+    ground_truth_table_.Erase(object);
+  }
+}
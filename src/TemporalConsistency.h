@@ -0,0 +1,144 @@
+//
+// Copyright 2023 BMW AG
+// SPDX-License-Identifier: MPL-2.0
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+ * Cross-frame consistency of tracked objects
+ *
+ * The tracking id table is an open-addressing hash map (linear probing,
+ * backward-shift deletion) with a fixed number of entries that is chosen
+ * at initialization.  All entries are kept in an intrusive LRU list, so
+ * when the table is full the least recently seen id is evicted.  Since
+ * every id is moved to the front when it is seen, the list is ordered by
+ * the frame an id was last seen in, and the ids absent for longest are
+ * found at its tail.  Lookup, insertion, removal, eviction and the LRU
+ * update are O(1), and no memory is allocated after Init().
+ */
+
+/* Check file entries enabling the temporal checks */
+constexpr const char* kCheckTemporalTimestamp = "temporal.timestamp";
+constexpr const char* kCheckTemporalTrackingId = "temporal.moving_object.header.tracking_id";
+
+/* Mix a 64 bit id into a well distributed hash value (splitmix64 finalizer) */
+inline uint64_t HashId(uint64_t id)
+{
+  id ^= id >> 30U;
+  id *= 0xbf58476d1ce4e5b9ULL;
+  id ^= id >> 27U;
+  id *= 0x94d049bb133111ebULL;
+  id ^= id >> 31U;
+  return id;
+}
+
+class TrackingIdTable
+{
+public:
+  struct Track
+  {
+    uint64_t id;
+    uint64_t first_frame;
+    uint64_t last_frame;
+    uint64_t linked_id;  // tracking id a ground truth id was last seen with
+    uint32_t prev;
+    uint32_t next;
+  };
+
+  void Init(size_t max_ids);
+  void Clear();
+  Track* Find(uint64_t id);
+  /* Insert a new id as most recently used, evicting the least recently used one if the table is full */
+  Track* Insert(uint64_t id, uint64_t frame, bool& evicted);
+  void Touch(Track* track);
+  void Erase(Track* track);
+  /* Least recently seen id, nullptr if the table is empty */
+  Track* Oldest() { return lru_tail_ == kNil ? nullptr : &entries_[lru_tail_]; }
+  size_t Size() const { return size_; }
+  size_t Capacity() const { return entries_.size(); }
+  size_t MemoryUsage() const { return entries_.capacity() * sizeof(Track) + slots_.capacity() * sizeof(uint32_t); }
+
+private:
+  static const uint32_t kNil = UINT32_MAX;
+
+  size_t HomeSlot(uint64_t id) const { return static_cast<size_t>(HashId(id)) & slot_mask_; }
+  void EraseSlot(uint64_t id);
+  void Unlink(uint32_t index);
+  void PushFront(uint32_t index);
+
+  std::vector<Track> entries_;
+  std::vector<uint32_t> slots_;  // entry index + 1, 0 marks an empty slot
+  size_t slot_mask_ = 0;
+  size_t size_ = 0;
+  size_t used_entries_ = 0;  // entries taken at least once since Clear(), erased ones are reused through free_head_
+  uint32_t free_head_ = kNil;
+  uint32_t lru_head_ = kNil;
+  uint32_t lru_tail_ = kNil;
+};
+
+class TemporalConsistencyChecker
+{
+public:
+  enum ObjectResult
+  {
+    kObjectNew,
+    kObjectPersistent,
+    kObjectDuplicate,
+    kObjectIdChanged
+  };
+
+  struct Statistics
+  {
+    uint64_t frames = 0;
+    uint64_t timestamp_violations = 0;
+    uint64_t duplicate_ids = 0;
+    uint64_t gap_violations = 0;  // ids that reappeared after more than max_absent_frames
+    uint64_t id_changes = 0;
+    uint64_t evictions = 0;  // ids evicted while absent for at most max_absent_frames
+  };
+
+  void Configure(size_t max_tracked_ids, uint32_t max_absent_frames);
+  void Reset();
+  /* Start a new frame, returns false if the timestamp did not increase */
+  bool BeginFrame(double timestamp);
+  /* Start a new frame without timestamp, the next timestamp is compared to the last one given */
+  void BeginFrame();
+
+  /*
+   * Register an object of the current frame.  If the object carries a
+   * ground truth id that was last seen with another tracking id, the
+   * tracking id of the object changed and previous_tracking_id is set.
+   * If the tracking id reappears after more than max_absent_frames frames,
+   * the object flickered and absent_frames is set to the length of the gap,
+   * otherwise it is 0.
+   */
+  ObjectResult UpdateObject(uint64_t tracking_id, const uint64_t* ground_truth_id, uint64_t& previous_tracking_id, uint64_t& absent_frames);
+
+  /*
+   * Finish the current frame.  Ground truth ids absent for more than
+   * max_absent_frames frames are forgotten, so an object that comes back
+   * later may get a new tracking id.  Absent tracking ids are kept until
+   * their entry is needed for a new id, so a tracking id that leaves the
+   * sensor for good is dropped silently.
+   */
+  void EndFrame();
+
+  const Statistics& GetStatistics() const { return statistics_; }
+  uint32_t MaxAbsentFrames() const { return max_absent_frames_; }
+  size_t MemoryUsage() const { return table_.MemoryUsage() + ground_truth_table_.MemoryUsage(); }
+  double LastTimestamp() const { return last_timestamp_; }
+
+private:
+  TrackingIdTable table_;
+  TrackingIdTable ground_truth_table_;  // ground truth id -> tracking id it was last seen with
+  uint32_t max_absent_frames_ = 0;
+  uint64_t frame_ = 0;
+  bool has_timestamp_ = false;
+  double last_timestamp_ = 0.0;
+  Statistics statistics_;
+};
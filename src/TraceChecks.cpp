@@ -0,0 +1,86 @@
+//
+// Copyright 2023 BMW AG
+// SPDX-License-Identifier: MPL-2.0
+//
+
+#include "TraceChecks.h"
+
+#include <algorithm>
+#include <functional>
+#include <thread>
+
+bool SplitTraceFrames(const void* data, size_t size, std::vector<TraceFrame>& frames)
+{
+  const auto* position = static_cast<const unsigned char*>(data);
+  const unsigned char* const end = position + size;
+  while (end - position >= 4)
+  {
+    const uint32_t frame_size = DecodeFrameSize(position);
+    position += 4;
+    if (frame_size > static_cast<size_t>(end - position))
+    {
+      return false;
+    }
+    frames.push_back({position, frame_size});
+    position += frame_size;
+  }
+  return position == end;
+}
+
+namespace
+{
+
+void CheckFrameRange(const std::vector<TraceFrame>& frames, size_t begin, size_t end, FieldCheckMask enabled_checks, uint64_t* checked, uint64_t* missing, uint8_t* parsed)
+{
+  osi3::SensorData sensor_data;  // reused for all frames of the range
+  for (size_t frame = begin; frame < end; frame++)
+  {
+    parsed[frame] = sensor_data.ParseFromArray(frames[frame].data, static_cast<int>(frames[frame].size)) ? 1 : 0;
+    FieldCounts counts;
+    CheckSensorDataFields(sensor_data, enabled_checks, counts);
+    for (int i = 0; i < kFieldCheckCount; i++)
+    {
+      const bool enabled = (enabled_checks & FieldCheckBit(static_cast<FieldCheck>(i))) != 0;
+      checked[frame * kFieldCheckCount + i] = enabled ? counts.checked[i] : 0;
+      missing[frame * kFieldCheckCount + i] = enabled ? counts.missing[i] : 0;
+    }
+  }
+}
+
+}  // namespace
+
+void CheckTraceFrames(const std::vector<TraceFrame>& frames, FieldCheckMask enabled_checks, size_t thread_count, uint64_t* checked, uint64_t* missing, uint8_t* parsed)
+{
+  thread_count = std::max<size_t>(std::min(thread_count, frames.size()), 1);
+  if (thread_count == 1)
+  {
+    CheckFrameRange(frames, 0, frames.size(), enabled_checks, checked, missing, parsed);
+    return;
+  }
+
+  /* Contiguous ranges of frames, so every thread writes its own rows */
+  std::vector<std::thread> threads;
+  threads.reserve(thread_count);
+  const size_t frames_per_thread = (frames.size() + thread_count - 1) / thread_count;
+  try
+  {
+    for (size_t begin = 0; begin < frames.size(); begin += frames_per_thread)
+    {
+      const size_t end = std::min(begin + frames_per_thread, frames.size());
+      threads.emplace_back(CheckFrameRange, std::cref(frames), begin, end, enabled_checks, checked, missing, parsed);
+    }
+  }
+  catch (...)
+  {
+    /* Destroying a joinable thread terminates the process, so the started ones are joined before the failure is passed on */
+    for (auto& thread : threads)
+    {
+      thread.join();
+    }
+    throw;
+  }
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+}
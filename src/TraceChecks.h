@@ -0,0 +1,45 @@
+//
+// Copyright 2023 BMW AG
+// SPDX-License-Identifier: MPL-2.0
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "FieldChecks.h"
+
+/*
+ * Field checks of serialized frames outside of the FMU
+ *
+ * Frames are checked in place from the memory of the caller with the same
+ * field checks as the FMU.  Every frame gets its own row of field counts,
+ * so frames can be distributed over threads without any synchronization
+ * besides joining them, and every thread reuses one parsed message.
+ */
+
+struct TraceFrame
+{
+  const void* data;
+  size_t size;
+};
+
+/* Size prefix of a frame in a binary OSI trace, 32 bit little-endian */
+inline uint32_t DecodeFrameSize(const unsigned char* prefix)
+{
+  return uint32_t(prefix[0]) | (uint32_t(prefix[1]) << 8U) | (uint32_t(prefix[2]) << 16U) | (uint32_t(prefix[3]) << 24U);
+}
+
+/* Split a trace of length-prefixed frames, returns false if it ends with a truncated frame, the complete frames before it are kept */
+bool SplitTraceFrames(const void* data, size_t size, std::vector<TraceFrame>& frames);
+
+/*
+ * Check frames on up to thread_count threads.  checked and missing receive
+ * kFieldCheckCount counts per frame, only for the enabled checks like the
+ * outputs of the FMU; parsed receives 0 for frames that could not be parsed
+ * completely, they are checked as far as they were parsed like in the FMU.
+ * Throws std::system_error if a thread cannot be started.
+ */
+void CheckTraceFrames(const std::vector<TraceFrame>& frames, FieldCheckMask enabled_checks, size_t thread_count, uint64_t* checked, uint64_t* missing, uint8_t* parsed);
@@ -0,0 +1,250 @@
+//
+// Copyright 2023 BMW AG
+// SPDX-License-Identifier: MPL-2.0
+//
+
+#include "TraceStream.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "TraceChecks.h"
+
+namespace
+{
+
+const size_t kInputBufferSize = 1U << 20U;
+const uint32_t kLz4FrameMagic = 0x184D2204U;
+const uint32_t kZstdFrameMagic = 0xFD2FB528U;
+
+}  // namespace
+
+TraceStream::~TraceStream()
+{
+#ifdef HAVE_LZ4
+  LZ4F_freeDecompressionContext(lz4_context_);
+#endif
+#ifdef HAVE_ZSTD
+  ZSTD_freeDStream(zstd_stream_);
+#endif
+}
+
+const char* TraceStream::CompressionName(Compression compression)
+{
+  switch (compression)
+  {
+    case kUncompressed:
+      return "uncompressed";
+    case kLz4:
+      return "LZ4";
+    case kZstd:
+      return "Zstandard";
+  }
+  return "";
+}
+
+bool TraceStream::Open(const std::string& path, std::string& error)
+{
+  file_.open(path, std::ios::in | std::ios::binary);
+  if (!file_.is_open())
+  {
+    error = "cannot open " + path;
+    return false;
+  }
+  input_.resize(kInputBufferSize);
+  FillInput();
+
+  /* A size prefix equal to one of the magic numbers would be a frame of more than 400 MB, so uncompressed traces are not mistaken */
+  const uint32_t magic = (input_end_ >= 4) ? DecodeFrameSize(reinterpret_cast<const unsigned char*>(input_.data())) : 0;
+  if (magic == kLz4FrameMagic)
+  {
+    compression_ = kLz4;
+#ifdef HAVE_LZ4
+    if (LZ4F_isError(LZ4F_createDecompressionContext(&lz4_context_, LZ4F_VERSION)))
+    {
+      error = "cannot create LZ4 decompression context";
+      return false;
+    }
+#else
+    error = path + " is LZ4 compressed, but LZ4 was not found when building the trace checker";
+    return false;
+#endif
+  }
+  else if (magic == kZstdFrameMagic)
+  {
+    compression_ = kZstd;
+#ifdef HAVE_ZSTD
+    zstd_stream_ = ZSTD_createDStream();
+    if (zstd_stream_ == nullptr || ZSTD_isError(ZSTD_initDStream(zstd_stream_)))
+    {
+      error = "cannot create Zstandard decompression context";
+      return false;
+    }
+#else
+    error = path + " is Zstandard compressed, but zstd was not found when building the trace checker";
+    return false;
+#endif
+  }
+  if (!error_.empty())
+  {
+    error = path + ": " + error_;
+    return false;
+  }
+  return true;
+}
+
+bool TraceStream::FillInput()
+{
+  if (input_begin_ < input_end_)
+  {
+    return true;
+  }
+  if (file_end_)
+  {
+    return false;
+  }
+  file_.read(input_.data(), static_cast<std::streamsize>(input_.size()));
+  input_begin_ = 0;
+  input_end_ = static_cast<size_t>(file_.gcount());
+  file_bytes_ += input_end_;
+  if (input_end_ < input_.size())
+  {
+    file_end_ = true;
+    if (file_.bad())
+    {
+      error_ = "read error";
+    }
+  }
+  return input_end_ > 0;
+}
+
+size_t TraceStream::Decompress(char* data, size_t size)
+{
+  switch (compression_)
+  {
+#ifdef HAVE_LZ4
+    case kLz4:
+    {
+      size_t produced = size;
+      size_t consumed = input_end_ - input_begin_;
+      const size_t hint = LZ4F_decompress(lz4_context_, data, &produced, input_.data() + input_begin_, &consumed, nullptr);
+      if (LZ4F_isError(hint))
+      {
+        error_ = std::string("LZ4 decompression failed: ") + LZ4F_getErrorName(hint);
+        return 0;
+      }
+      input_begin_ += consumed;
+      if (produced > 0 || consumed > 0)
+      {
+        stream_end_ = (hint == 0);
+      }
+      return produced;
+    }
+#endif
+#ifdef HAVE_ZSTD
+    case kZstd:
+    {
+      ZSTD_inBuffer input = {input_.data() + input_begin_, input_end_ - input_begin_, 0};
+      ZSTD_outBuffer output = {data, size, 0};
+      const size_t hint = ZSTD_decompressStream(zstd_stream_, &output, &input);
+      if (ZSTD_isError(hint))
+      {
+        error_ = std::string("Zstandard decompression failed: ") + ZSTD_getErrorName(hint);
+        return 0;
+      }
+      input_begin_ += input.pos;
+      if (output.pos > 0 || input.pos > 0)
+      {
+        stream_end_ = (hint == 0);
+      }
+      return output.pos;
+    }
+#endif
+    default:
+      static_cast<void>(data);  // without the decompression libraries
+      static_cast<void>(size);
+      return 0;
+  }
+}
+
+size_t TraceStream::Read(char* data, size_t size)
+{
+  size_t done = 0;
+  while (done < size && error_.empty())
+  {
+    const bool input_available = FillInput();
+    if (compression_ == kUncompressed)
+    {
+      if (!input_available)
+      {
+        break;
+      }
+      const size_t length = std::min(size - done, input_end_ - input_begin_);
+      memcpy(data + done, input_.data() + input_begin_, length);
+      input_begin_ += length;
+      done += length;
+      continue;
+    }
+
+    /* Without input, the decompressor may still hold output of the last block */
+    const size_t input_begin = input_begin_;
+    const size_t length = Decompress(data + done, size - done);
+    done += length;
+    if (length == 0 && input_begin_ == input_begin)
+    {
+      if (input_available && error_.empty())
+      {
+        error_ = "decompression does not progress";
+      }
+      break;
+    }
+  }
+  trace_bytes_ += done;
+  return done;
+}
+
+bool TraceStream::ReadFrame(std::string& frame)
+{
+  if (!error_.empty())
+  {
+    return false;
+  }
+  unsigned char prefix[4];
+  const size_t prefix_length = Read(reinterpret_cast<char*>(prefix), sizeof(prefix));
+  if (prefix_length < sizeof(prefix))
+  {
+    if (!error_.empty())
+    {
+      return false;
+    }
+    if (prefix_length > 0)
+    {
+      error_ = "trace ends within the size of a frame";
+    }
+    else if (!stream_end_)
+    {
+      error_ = std::string(CompressionName(compression_)) + " stream is truncated";
+    }
+    return false;
+  }
+
+  /* The frame grows with the bytes actually read, so a corrupt size prefix does not allocate up to 4 GB */
+  const uint32_t frame_size = DecodeFrameSize(prefix);
+  size_t frame_read = 0;
+  while (frame_read < frame_size)
+  {
+    frame.resize(std::min<size_t>(frame_size, std::max(frame_read * 2, kInputBufferSize)));
+    const size_t length = Read(&frame[frame_read], frame.size() - frame_read);
+    frame_read += length;
+    if (frame_read < frame.size())
+    {
+      if (error_.empty())
+      {
+        error_ = "trace ends within a frame of " + std::to_string(frame_size) + " bytes";
+      }
+      return false;
+    }
+  }
+  frame.resize(frame_size);
+  return true;
+}
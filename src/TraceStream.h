@@ -0,0 +1,87 @@
+//
+// Copyright 2023 BMW AG
+// SPDX-License-Identifier: MPL-2.0
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#ifdef HAVE_LZ4
+#include <lz4frame.h>
+#endif
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+/*
+ * Sequential reading of binary OSI traces
+ *
+ * The frames of a trace, each preceded by its size as 32 bit little-endian
+ * integer, are read one after another from a file.  Traces compressed with
+ * LZ4 (frame format, .osi.lz4) or Zstandard (.osi.zst) are detected from
+ * the magic number of the file and decompressed while reading, without
+ * writing the decompressed trace anywhere.  Memory use is the fixed input
+ * buffer, the decompression context and the largest frame, independent of
+ * the length of the trace.
+ */
+class TraceStream
+{
+public:
+  enum Compression
+  {
+    kUncompressed,
+    kLz4,
+    kZstd
+  };
+
+  TraceStream() = default;
+  ~TraceStream();
+  TraceStream(const TraceStream&) = delete;
+  TraceStream& operator=(const TraceStream&) = delete;
+
+  /* Compressed traces are only supported if the tool was built with the respective library */
+  bool Open(const std::string& path, std::string& error);
+
+  /*
+   * Next frame of the trace, the memory of frame is reused.  Returns false at
+   * the end of the trace, Error() tells whether the trace ended regularly.
+   */
+  bool ReadFrame(std::string& frame);
+
+  /* Empty at the regular end of the trace, otherwise why reading stopped */
+  const std::string& Error() const { return error_; }
+  Compression GetCompression() const { return compression_; }
+  uint64_t FileBytes() const { return file_bytes_; }
+  uint64_t TraceBytes() const { return trace_bytes_; }
+
+  static const char* CompressionName(Compression compression);
+
+private:
+  /* Decompressed bytes of the trace, fewer than size only at its end or on errors */
+  size_t Read(char* data, size_t size);
+  size_t Decompress(char* data, size_t size);
+  bool FillInput();
+
+  std::ifstream file_;
+  bool file_end_ = false;
+  Compression compression_ = kUncompressed;
+  std::vector<char> input_;
+  size_t input_begin_ = 0;
+  size_t input_end_ = 0;
+  bool stream_end_ = true;  // the compressed stream ended with a complete compressed frame
+  uint64_t file_bytes_ = 0;
+  uint64_t trace_bytes_ = 0;
+  std::string error_;
+
+#ifdef HAVE_LZ4
+  LZ4F_dctx* lz4_context_ = nullptr;
+#endif
+#ifdef HAVE_ZSTD
+  ZSTD_DStream* zstd_stream_ = nullptr;
+#endif
+};
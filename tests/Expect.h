@@ -0,0 +1,34 @@
+//
+// Copyright 2023 BMW AG
+// SPDX-License-Identifier: MPL-2.0
+//
+
+#pragma once
+
+#include <iostream>
+
+/*
+ * Minimal expectations for the test executables: a failed expectation is
+ * printed with its location and the test returns TestResult() from main.
+ */
+
+inline int& ExpectationFailures()
+{
+  static int failures = 0;
+  return failures;
+}
+
+#define EXPECT(condition)                                                                  \
+  do                                                                                       \
+  {                                                                                        \
+    if (!(condition))                                                                      \
+    {                                                                                      \
+      std::cerr << __FILE__ << ":" << __LINE__ << ": expected " << #condition << std::endl; \
+      ExpectationFailures()++;                                                             \
+    }                                                                                      \
+  } while (false)
+
+inline int TestResult()
+{
+  return ExpectationFailures() == 0 ? 0 : 1;
+}
@@ -0,0 +1,107 @@
+//
+// Copyright 2023 BMW AG
+// SPDX-License-Identifier: MPL-2.0
+//
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "AsyncLogger.h"
+#include "Expect.h"
+
+namespace
+{
+
+/* Messages as received by the sink, written on the logger thread and read after Flush() */
+struct Received
+{
+  std::vector<std::string> messages;
+  int empty_notifications = 0;
+};
+
+AsyncLogger::Sink Collect(Received& received)
+{
+  return [&received](LogCategory /*category*/, uint32_t /*sinks*/, const char* message) {
+    if (message == nullptr)
+    {
+      received.empty_notifications++;
+    }
+    else
+    {
+      received.messages.emplace_back(message);
+    }
+  };
+}
+
+/* Flush returns once every message was passed to the sink and the sink was told that the ring ran empty */
+void TestFlush()
+{
+  Received received;
+  AsyncLogger logger(Collect(received), 64);
+  for (int i = 0; i < 50; i++)
+  {
+    logger.Log(kLogOsi, 0, "message %d of %s", i, "test");
+  }
+  logger.Flush();
+  EXPECT(received.messages.size() == 50);
+  EXPECT(received.messages.front() == "message 0 of test");
+  EXPECT(received.messages.back() == "message 49 of test");
+  EXPECT(received.empty_notifications >= 1);
+  EXPECT(logger.Dropped() == 0);
+}
+
+/* A message logged while the logger thread sleeps wakes it up */
+void TestWakeUp()
+{
+  Received received;
+  AsyncLogger logger(Collect(received), 16);
+  for (int round = 0; round < 20; round++)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    logger.Log(kLogFmi, 0, "round %d", round);
+    logger.Flush();
+    EXPECT(received.messages.size() == static_cast<size_t>(round + 1));
+  }
+}
+
+/* A full ring drops instead of blocking, and the drops are counted */
+void TestDropped()
+{
+  Received received;
+  {
+    AsyncLogger logger(Collect(received), 4);
+    for (int i = 0; i < 10000; i++)
+    {
+      logger.Log(kLogOsmp, 0, "%d", i);
+    }
+    logger.Flush();
+    EXPECT(received.messages.size() + logger.Dropped() == 10000);
+  }
+}
+
+/* Records still in the ring are passed to the sink before the logger is destroyed */
+void TestDestructorDrains()
+{
+  Received received;
+  {
+    AsyncLogger logger(Collect(received), 64);
+    for (int i = 0; i < 32; i++)
+    {
+      logger.Log(kLogOsi, 0, "%u", static_cast<unsigned>(i));
+    }
+  }
+  EXPECT(received.messages.size() == 32);
+}
+
+}  // namespace
+
+int main()
+{
+  TestFlush();
+  TestWakeUp();
+  TestDropped();
+  TestDestructorDrains();
+  return TestResult();
+}
@@ -0,0 +1,176 @@
+//
+// Copyright 2023 BMW AG
+// SPDX-License-Identifier: MPL-2.0
+//
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Expect.h"
+#include "FrameCapture.h"
+
+namespace
+{
+
+const char* const kCaptureFile = "TestFrameCapture.osi";
+
+std::string Frame(int index)
+{
+  return "frame " + std::to_string(index) + std::string(static_cast<size_t>(index % 7), 'x');
+}
+
+/* The frames of a capture file, each preceded by its size as 32 bit little-endian integer */
+std::vector<std::string> ReadCapture(const std::string& path)
+{
+  std::ifstream file(path, std::ios::in | std::ios::binary);
+  std::stringstream content;
+  content << file.rdbuf();
+  const std::string data = content.str();
+  std::vector<std::string> frames;
+  size_t position = 0;
+  while (position + 4 <= data.size())
+  {
+    const auto* prefix = reinterpret_cast<const unsigned char*>(data.data() + position);
+    const size_t size = prefix[0] | (prefix[1] << 8U) | (prefix[2] << 16U) | (static_cast<size_t>(prefix[3]) << 24U);
+    EXPECT(position + 4 + size <= data.size());
+    frames.push_back(data.substr(position + 4, size));
+    position += 4 + size;
+  }
+  EXPECT(position == data.size());
+  return frames;
+}
+
+/* The first occurrences of every field are captured, after that every stride-th one */
+void TestRateLimit()
+{
+  FrameCapture capture;
+  EXPECT(capture.Open(kCaptureFile, 2, 3, 1024));
+  const bool expected[] = {true, true, false, false, true, false, false, true};
+  for (bool capture_expected : expected)
+  {
+    EXPECT(capture.CountOccurrence(0) == capture_expected);
+  }
+  EXPECT(capture.CountOccurrence(5));  // fields are counted separately
+  EXPECT(capture.CountOccurrence(5));
+  EXPECT(!capture.CountOccurrence(5));
+
+  /* Stride 0 captures only the first occurrences */
+  EXPECT(capture.Open(kCaptureFile, 1, 0, 1024));
+  EXPECT(capture.CountOccurrence(0));
+  for (int i = 0; i < 100; i++)
+  {
+    EXPECT(!capture.CountOccurrence(0));
+  }
+  capture.Close();
+  std::remove(kCaptureFile);
+}
+
+/* Frames queued with pauses in between wake the writer thread and are written in order */
+void TestWrite()
+{
+  FrameCapture capture;
+  EXPECT(capture.Open(kCaptureFile, 1, 1, 1024 * 1024));
+  std::vector<std::string> frames;
+  for (int i = 0; i < 20; i++)
+  {
+    frames.push_back(Frame(i));
+    capture.Capture(frames.back().data(), frames.back().size());
+    if (i % 5 == 0)
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+  capture.Close();
+  const FrameCapture::Statistics statistics = capture.GetStatistics();
+  EXPECT(statistics.captured_frames == frames.size());
+  EXPECT(statistics.dropped_queue_full == 0 && statistics.dropped_size_limit == 0 && statistics.dropped_write_error == 0);
+  EXPECT(ReadCapture(kCaptureFile) == frames);
+  uint64_t bytes = 0;
+  for (const auto& frame : frames)
+  {
+    bytes += 4 + frame.size();
+  }
+  EXPECT(statistics.captured_bytes == bytes);
+  std::remove(kCaptureFile);
+}
+
+/* Frames that would exceed max_bytes are dropped, smaller ones still fit */
+void TestSizeLimit()
+{
+  FrameCapture capture;
+  EXPECT(capture.Open(kCaptureFile, 1, 1, 100));
+  const std::string large(60, 'l');
+  const std::string small(20, 's');
+  capture.Capture(large.data(), large.size());
+  capture.Capture(large.data(), large.size());
+  capture.Capture(small.data(), small.size());
+  capture.Close();
+  const FrameCapture::Statistics statistics = capture.GetStatistics();
+  EXPECT(statistics.captured_frames == 2);
+  EXPECT(statistics.captured_bytes == 88);
+  EXPECT(statistics.dropped_size_limit == 1);
+  EXPECT(ReadCapture(kCaptureFile) == std::vector<std::string>({large, small}));
+  std::remove(kCaptureFile);
+}
+
+/* A full queue drops frames instead of blocking, every frame is either written or counted as dropped */
+void TestQueueFull()
+{
+  FrameCapture capture;
+  EXPECT(capture.Open(kCaptureFile, 1, 1, 1024 * 1024 * 1024, 2));
+  const std::string frame(64 * 1024, 'q');
+  const uint64_t frame_count = 2000;
+  for (uint64_t i = 0; i < frame_count; i++)
+  {
+    capture.Capture(frame.data(), frame.size());
+  }
+  capture.Close();
+  const FrameCapture::Statistics statistics = capture.GetStatistics();
+  EXPECT(statistics.dropped_queue_full > 0);
+  EXPECT(statistics.captured_frames + statistics.dropped_queue_full == frame_count);
+  EXPECT(ReadCapture(kCaptureFile).size() == statistics.captured_frames);
+  std::remove(kCaptureFile);
+}
+
+#ifdef __linux__
+/* Frames that cannot be written do not count as captured */
+void TestWriteError()
+{
+  FrameCapture capture;
+  if (!capture.Open("/dev/full", 1, 1, 1024 * 1024 * 1024))
+  {
+    return;
+  }
+  const std::string frame(64 * 1024, 'e');
+  for (int i = 0; i < 10; i++)
+  {
+    capture.Capture(frame.data(), frame.size());
+  }
+  capture.Close();
+  const FrameCapture::Statistics statistics = capture.GetStatistics();
+  EXPECT(statistics.captured_frames == 0);
+  EXPECT(statistics.captured_bytes == 0);
+  EXPECT(statistics.dropped_write_error + statistics.dropped_queue_full == 10);
+  EXPECT(statistics.dropped_write_error > 0);
+}
+#endif
+
+}  // namespace
+
+int main()
+{
+  TestRateLimit();
+  TestWrite();
+  TestSizeLimit();
+  TestQueueFull();
+#ifdef __linux__
+  TestWriteError();
+#endif
+  return TestResult();
+}
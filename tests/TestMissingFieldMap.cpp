@@ -0,0 +1,83 @@
+//
+// Copyright 2023 BMW AG
+// SPDX-License-Identifier: MPL-2.0
+//
+
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <string>
+
+#include "Expect.h"
+#include "MissingFieldMap.h"
+
+namespace
+{
+
+osi3::DetectedMovingObject Object(double x, double y, double z)
+{
+  osi3::DetectedMovingObject moving_object;
+  moving_object.mutable_base()->mutable_position()->set_x(x);
+  moving_object.mutable_base()->mutable_position()->set_y(y);
+  moving_object.mutable_base()->mutable_position()->set_z(z);
+  return moving_object;
+}
+
+std::string ReadCsv(const MissingFieldMap& map)
+{
+  const std::string path = "TestMissingFieldMap.csv";
+  EXPECT(map.WriteCsv(path));
+  std::ifstream file(path);
+  std::stringstream content;
+  content << file.rdbuf();
+  file.close();
+  std::remove(path.c_str());
+  return content.str();
+}
+
+/* base.position of detected objects is in sensor coordinates, it is binned as given */
+void TestSensorCoordinates()
+{
+  MissingFieldMap map;
+  map.Configure(10, 8, 100.0);  // 10 m and 45 deg bins
+  EXPECT(map.IsEnabled());
+  map.Add(Object(15.0, 1.0, 3.0), true);     // ahead, z is ignored
+  map.Add(Object(15.0, 2.0, 0.0), false);    // same bin
+  map.Add(Object(0.0, -25.0, 0.0), true);    // 90 deg to the right
+  map.Add(Object(-150.0, 1.0, 0.0), false);  // behind, beyond the range
+  map.Add(osi3::DetectedMovingObject(), true);
+  map.Add(Object(std::numeric_limits<double>::quiet_NaN(), 0.0, 0.0), false);
+
+  EXPECT(map.MissingObjects() == 3);
+  EXPECT(map.UnplacedObjects() == 2);
+  EXPECT(ReadCsv(map) ==
+         "range_min,range_max,azimuth_min,azimuth_max,objects,objects_missing_fields\n"
+         "10,20,0,45,2,1\n"
+         "20,30,-90,-45,1,1\n"
+         "100,inf,135,180,1,0\n");
+
+  map.Reset();
+  EXPECT(map.MissingObjects() == 0);
+  EXPECT(ReadCsv(map) == "range_min,range_max,azimuth_min,azimuth_max,objects,objects_missing_fields\n");
+}
+
+void TestDisabled()
+{
+  MissingFieldMap map;
+  EXPECT(!map.IsEnabled());
+  map.Configure(10, 0, 100.0);
+  EXPECT(!map.IsEnabled());
+  map.Configure(10, 8, 0.0);
+  EXPECT(!map.IsEnabled());
+  EXPECT(map.MemoryUsage() == 0);
+}
+
+}  // namespace
+
+int main()
+{
+  TestSensorCoordinates();
+  TestDisabled();
+  return TestResult();
+}
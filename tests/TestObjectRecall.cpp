@@ -0,0 +1,109 @@
+//
+// Copyright 2023 BMW AG
+// SPDX-License-Identifier: MPL-2.0
+//
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "Expect.h"
+#include "ObjectRecall.h"
+
+namespace
+{
+
+const double kPi = 3.14159265358979323846;
+
+void AddObject(osi3::GroundTruth& ground_truth, uint64_t id, double x, double y, double z)
+{
+  osi3::MovingObject* moving_object = ground_truth.add_moving_object();
+  moving_object->mutable_id()->set_value(id);
+  moving_object->mutable_base()->mutable_position()->set_x(x);
+  moving_object->mutable_base()->mutable_position()->set_y(y);
+  moving_object->mutable_base()->mutable_position()->set_z(z);
+}
+
+/*
+ * Host at (100, 0) facing global +y, rear axle 1 m behind the bounding box
+ * center and a front sensor 3 m ahead of the rear axle, so the sensor is at
+ * (100, 2) and looks along global +y.  Nothing is detected, so the missed
+ * ids are the objects within the region.
+ */
+osi3::SensorView Scene()
+{
+  osi3::SensorView sensor_view;
+  sensor_view.mutable_mounting_position()->mutable_position()->set_x(3.0);
+  osi3::GroundTruth& ground_truth = *sensor_view.mutable_global_ground_truth();
+  ground_truth.mutable_host_vehicle_id()->set_value(1);
+  AddObject(ground_truth, 1, 100.0, 0.0, 0.0);
+  osi3::MovingObject& host = *ground_truth.mutable_moving_object(0);
+  host.mutable_base()->mutable_orientation()->set_yaw(0.5 * kPi);
+  host.mutable_vehicle_attributes()->mutable_bbcenter_to_rear()->set_x(-1.0);
+
+  AddObject(ground_truth, 2, 100.0, 52.0, 0.0);   // 50 m straight ahead of the sensor
+  AddObject(ground_truth, 3, 100.0, -53.0, 0.0);  // 55 m behind the sensor
+  AddObject(ground_truth, 4, 130.0, 42.0, 0.0);   // 50 m ahead, 36.9 deg to the right
+  AddObject(ground_truth, 5, 100.0, 61.5, 0.0);   // 59.5 m from the sensor, 61.5 m from the host center
+  AddObject(ground_truth, 6, 100.0, 22.0, 20.0);  // 45 deg above the sensor
+  return sensor_view;
+}
+
+std::vector<uint64_t> Missed(const osi3::SensorView& sensor_view, double range, double fov_horizontal, double fov_vertical)
+{
+  ObjectRecallChecker checker;
+  RecallRegion region;
+  region.range = range;
+  region.fov_horizontal = fov_horizontal;
+  region.fov_vertical = fov_vertical;
+  checker.Check(sensor_view, osi3::SensorData(), region);
+  std::vector<uint64_t> missed_ids = checker.MissedIds();
+  std::sort(missed_ids.begin(), missed_ids.end());
+  return missed_ids;
+}
+
+/* Range is measured from the sensor, not from the bounding box center of the host */
+void TestRangeFromSensor()
+{
+  EXPECT(Missed(Scene(), 60.0, 0.0, 0.0) == std::vector<uint64_t>({2, 3, 4, 5, 6}));
+  EXPECT(Missed(Scene(), 52.0, 0.0, 0.0) == std::vector<uint64_t>({2, 4, 6}));
+}
+
+void TestHorizontalFieldOfView()
+{
+  EXPECT(Missed(Scene(), 60.0, 0.5 * kPi, 0.0) == std::vector<uint64_t>({2, 4, 5, 6}));
+  EXPECT(Missed(Scene(), 60.0, kPi / 3.0, 0.0) == std::vector<uint64_t>({2, 5, 6}));
+}
+
+void TestVerticalFieldOfView()
+{
+  EXPECT(Missed(Scene(), 60.0, 0.0, kPi / 3.0) == std::vector<uint64_t>({2, 3, 4, 5}));
+}
+
+/* The mounting orientation turns the field of view, here the sensor looks backwards */
+void TestMountingOrientation()
+{
+  osi3::SensorView sensor_view = Scene();
+  sensor_view.mutable_mounting_position()->mutable_orientation()->set_yaw(kPi);
+  EXPECT(Missed(sensor_view, 60.0, 0.5 * kPi, 0.0) == std::vector<uint64_t>({3}));
+}
+
+/* Without a host vehicle, there is nothing to place the region, so every object counts */
+void TestWithoutHost()
+{
+  osi3::SensorView sensor_view = Scene();
+  sensor_view.mutable_global_ground_truth()->clear_host_vehicle_id();
+  EXPECT(Missed(sensor_view, 1.0, 0.1, 0.1).size() == 6);
+}
+
+}  // namespace
+
+int main()
+{
+  TestRangeFromSensor();
+  TestHorizontalFieldOfView();
+  TestVerticalFieldOfView();
+  TestMountingOrientation();
+  TestWithoutHost();
+  return TestResult();
+}
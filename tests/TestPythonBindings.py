@@ -0,0 +1,151 @@
+#
+# Copyright 2023 BMW AG
+# SPDX-License-Identifier: MPL-2.0
+#
+
+"""
+Tests of the Python module osi_field_checker against OSITraceChecker
+
+A trace written by WriteTestTrace is checked with the module and with
+OSITraceChecker, which prints the same reports as the FMU at fmi2Terminate,
+and the reports have to be equal.
+
+Usage: TestPythonBindings.py <module_dir> <WriteTestTrace> <OSITraceChecker> <work_dir>
+"""
+
+import os
+import subprocess
+import sys
+import unittest
+
+MODULE_DIR, WRITE_TEST_TRACE, TRACE_CHECKER, WORK_DIR = sys.argv[1:5]
+sys.path.insert(0, MODULE_DIR)
+
+try:
+    import numpy
+except ImportError:
+    print("numpy is not installed, skipping the tests of the Python bindings")
+    sys.exit(77)
+
+import osi_field_checker
+
+FRAMES = 20
+MIN_FILL_RATE = 0.9
+CHECKS = [
+    "moving_object",
+    "moving_object.base",
+    "moving_object.base.velocity",
+    "moving_object.base.base_polygon",
+    "feature_data.lidar_sensor.detection",
+    "feature_data.lidar_sensor.detection.intensity",
+]
+
+
+def field_reports(output):
+    """Lines of the field statistics, in the order they are printed"""
+    return [line for line in output.splitlines() if line.startswith(("::error title=MissingField::", "::warning title=FillRate::"))]
+
+
+class TestPythonBindings(unittest.TestCase):
+    @classmethod
+    def setUpClass(cls):
+        os.makedirs(WORK_DIR, exist_ok=True)
+        cls.check_file = os.path.join(WORK_DIR, "osi_check.txt")
+        with open(cls.check_file, "w") as check_file:
+            check_file.write("\n".join(CHECKS) + "\n")
+        cls.trace_file = os.path.join(WORK_DIR, "test.osi")
+        subprocess.run([WRITE_TEST_TRACE, cls.trace_file, str(FRAMES)], check=True)
+        with open(cls.trace_file, "rb") as trace:
+            cls.trace = trace.read()
+        cls.checker = osi_field_checker.FieldChecker(cls.check_file)
+
+    def trace_checker_reports(self, trace_file):
+        result = subprocess.run([TRACE_CHECKER, self.check_file, trace_file, str(MIN_FILL_RATE)], stdout=subprocess.PIPE, universal_newlines=True)
+        return field_reports(result.stdout)
+
+    def test_report_matches_trace_checker(self):
+        expected = self.trace_checker_reports(self.trace_file)
+        self.assertTrue(any(line.startswith("::error") for line in expected))
+        self.assertTrue(any(line.startswith("::warning") for line in expected))
+
+        result = self.checker.check_trace(self.trace)
+        self.assertEqual(result["checked"].shape, (FRAMES, len(osi_field_checker.field_names)))
+        self.assertFalse(result["truncated"])
+        self.assertEqual(osi_field_checker.report(result["checked"], result["missing"], min_fill_rate=MIN_FILL_RATE), expected)
+
+        # Counts summed over the frames give the same verdicts, but count as a single frame
+        totals = osi_field_checker.report(result["checked"].sum(axis=0), result["missing"].sum(axis=0), min_fill_rate=MIN_FILL_RATE)
+        self.assertEqual([line.split(" missing in ")[0] for line in totals], [line.split(" missing in ")[0] for line in expected])
+
+    def test_threads(self):
+        single = self.checker.check_trace(self.trace)
+        threaded = self.checker.check_trace(self.trace, threads=4)
+        numpy.testing.assert_array_equal(single["checked"], threaded["checked"])
+        numpy.testing.assert_array_equal(single["missing"], threaded["missing"])
+        with self.assertRaises(ValueError):
+            self.checker.check_trace(self.trace, threads=0)
+
+    def test_enabled(self):
+        enabled = self.checker.enabled
+        self.assertEqual(enabled.dtype, numpy.bool_)
+        self.assertEqual([name for name, on in zip(osi_field_checker.field_names, enabled) if on], CHECKS)
+
+    def test_counts_of_disabled_checks_are_zero(self):
+        result = self.checker.check_trace(self.trace)
+        disabled = ~self.checker.enabled
+        self.assertEqual(result["checked"][:, disabled].sum(), 0)
+        self.assertTrue(result["checked"][:, self.checker.enabled].all())
+
+    def test_contiguous_buffers(self):
+        expected = self.checker.check_trace(self.trace)
+        as_array = numpy.frombuffer(self.trace, dtype=numpy.uint8)
+        for buffer in (bytearray(self.trace), memoryview(self.trace), as_array, as_array.reshape(1, -1)):
+            result = self.checker.check_trace(buffer)
+            numpy.testing.assert_array_equal(result["missing"], expected["missing"])
+        with self.assertRaises(ValueError):
+            self.checker.check_trace(as_array[::2])
+        with self.assertRaises(TypeError):
+            self.checker.check_trace("not a buffer")
+
+    def test_parsed_flags(self):
+        frames = self.split_trace()[:3]
+        frames[1] = b"\x22\xff"  # length-delimited field reaching past the end
+        result = self.checker.check_frames(frames)
+        self.assertEqual(result["parsed"].dtype, numpy.bool_)
+        self.assertEqual(result["parsed"].tolist(), [True, False, True])
+        numpy.testing.assert_array_equal(result["missing"][0], self.checker.check(frames[0])["missing"])
+        self.assertEqual(self.checker.check(frames[0])["checked"].shape, (len(osi_field_checker.field_names),))
+        self.assertIs(self.checker.check(frames[0])["parsed"], True)
+        self.assertIs(self.checker.check(frames[1])["parsed"], False)
+
+    def test_check_frames_matches_trace(self):
+        expected = self.checker.check_trace(self.trace)
+        result = self.checker.check_frames(self.split_trace(), threads=3)
+        numpy.testing.assert_array_equal(result["checked"], expected["checked"])
+        numpy.testing.assert_array_equal(result["missing"], expected["missing"])
+
+    def test_truncated_trace(self):
+        result = self.checker.check_trace(self.trace[:-3])
+        self.assertTrue(result["truncated"])
+        self.assertEqual(result["checked"].shape[0], FRAMES - 1)
+
+    def test_report_shape(self):
+        with self.assertRaises(ValueError):
+            osi_field_checker.report(numpy.zeros(3), numpy.zeros(3))
+
+    def test_missing_check_file(self):
+        with self.assertRaises(RuntimeError):
+            osi_field_checker.FieldChecker(os.path.join(WORK_DIR, "missing.txt"))
+
+    def split_trace(self):
+        frames = []
+        position = 0
+        while position < len(self.trace):
+            size = int.from_bytes(self.trace[position : position + 4], "little")
+            frames.append(self.trace[position + 4 : position + 4 + size])
+            position += 4 + size
+        return frames
+
+
+if __name__ == "__main__":
+    unittest.main(argv=sys.argv[:1])
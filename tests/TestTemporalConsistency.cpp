@@ -0,0 +1,218 @@
+//
+// Copyright 2023 BMW AG
+// SPDX-License-Identifier: MPL-2.0
+//
+
+#include <cstdint>
+#include <vector>
+
+#include "Expect.h"
+#include "TemporalConsistency.h"
+
+namespace
+{
+
+const uint32_t kMaxAbsentFrames = 2;
+
+/* One frame of objects given as pairs of tracking id and ground truth id, returns the ids reported as reappeared after too long a gap */
+std::vector<uint64_t> Frame(TemporalConsistencyChecker& checker, double timestamp, const std::vector<std::pair<uint64_t, uint64_t>>& objects)
+{
+  checker.BeginFrame(timestamp);
+  std::vector<uint64_t> reappeared_ids;
+  for (const auto& object : objects)
+  {
+    uint64_t previous_tracking_id = 0;
+    uint64_t absent_frames = 0;
+    checker.UpdateObject(object.first, &object.second, previous_tracking_id, absent_frames);
+    if (absent_frames > 0)
+    {
+      reappeared_ids.push_back(object.first);
+    }
+  }
+  checker.EndFrame();
+  return reappeared_ids;
+}
+
+/* An id that leaves and never returns is not a violation, the object may just have left the sensor */
+void TestDepartingId()
+{
+  TemporalConsistencyChecker checker;
+  checker.Configure(16, kMaxAbsentFrames);
+  double timestamp = 0.0;
+  for (int frame = 0; frame < 3; frame++)
+  {
+    EXPECT(Frame(checker, timestamp += 0.1, {{1, 101}, {2, 102}}).empty());
+  }
+  for (int frame = 0; frame < 10; frame++)
+  {
+    EXPECT(Frame(checker, timestamp += 0.1, {{1, 101}}).empty());
+  }
+  EXPECT(checker.GetStatistics().gap_violations == 0);
+  EXPECT(checker.GetStatistics().evictions == 0);
+}
+
+/* An id that comes back after more than the limit flickered */
+void TestFlickerBeyondLimit()
+{
+  TemporalConsistencyChecker checker;
+  checker.Configure(16, kMaxAbsentFrames);
+  double timestamp = 0.0;
+  EXPECT(Frame(checker, timestamp += 0.1, {{1, 101}, {2, 102}}).empty());
+  for (uint32_t frame = 0; frame <= kMaxAbsentFrames; frame++)
+  {
+    EXPECT(Frame(checker, timestamp += 0.1, {{1, 101}}).empty());
+  }
+  uint64_t previous_tracking_id = 0;
+  uint64_t absent_frames = 0;
+  const uint64_t second_object = 102;
+  checker.BeginFrame(timestamp += 0.1);
+  checker.UpdateObject(2, &second_object, previous_tracking_id, absent_frames);
+  checker.EndFrame();
+  EXPECT(absent_frames == kMaxAbsentFrames + 1);
+  EXPECT(checker.GetStatistics().gap_violations == 1);
+
+  /* Present again, so the next frames are fine */
+  EXPECT(Frame(checker, timestamp += 0.1, {{1, 101}, {2, 102}}).empty());
+  EXPECT(checker.GetStatistics().gap_violations == 1);
+}
+
+/* An id that is absent within the limit and comes back is fine */
+void TestFlickerWithinLimit()
+{
+  TemporalConsistencyChecker checker;
+  checker.Configure(16, kMaxAbsentFrames);
+  double timestamp = 0.0;
+  EXPECT(Frame(checker, timestamp += 0.1, {{1, 101}, {2, 102}}).empty());
+  EXPECT(Frame(checker, timestamp += 0.1, {{1, 101}}).empty());
+  EXPECT(Frame(checker, timestamp += 0.1, {{1, 101}}).empty());
+  EXPECT(Frame(checker, timestamp += 0.1, {{1, 101}, {2, 102}}).empty());
+  for (int frame = 0; frame < 5; frame++)
+  {
+    EXPECT(Frame(checker, timestamp += 0.1, {{1, 101}, {2, 102}}).empty());
+  }
+  EXPECT(checker.GetStatistics().gap_violations == 0);
+  EXPECT(checker.GetStatistics().id_changes == 0);
+}
+
+/* The same ground truth object reappearing under a new tracking id is an id change */
+void TestReplacedId()
+{
+  TemporalConsistencyChecker checker;
+  checker.Configure(16, kMaxAbsentFrames);
+  double timestamp = 0.0;
+  EXPECT(Frame(checker, timestamp += 0.1, {{1, 101}, {2, 102}}).empty());
+  EXPECT(Frame(checker, timestamp += 0.1, {{1, 101}, {2, 102}}).empty());
+
+  checker.BeginFrame(timestamp += 0.1);
+  uint64_t previous_tracking_id = 0;
+  uint64_t absent_frames = 0;
+  const uint64_t first_object = 101;
+  const uint64_t second_object = 102;
+  EXPECT(checker.UpdateObject(1, &first_object, previous_tracking_id, absent_frames) == TemporalConsistencyChecker::kObjectPersistent);
+  EXPECT(checker.UpdateObject(7, &second_object, previous_tracking_id, absent_frames) == TemporalConsistencyChecker::kObjectIdChanged);
+  EXPECT(previous_tracking_id == 2);
+  checker.EndFrame();
+  EXPECT(checker.GetStatistics().id_changes == 1);
+
+  /* The new id is kept, the replaced one is not reported again */
+  for (int frame = 0; frame < 5; frame++)
+  {
+    EXPECT(Frame(checker, timestamp += 0.1, {{1, 101}, {7, 102}}).empty());
+  }
+  EXPECT(checker.GetStatistics().id_changes == 1);
+  EXPECT(checker.GetStatistics().gap_violations == 0);
+
+  /* Objects without ground truth id cannot be checked for id changes */
+  checker.BeginFrame(timestamp += 0.1);
+  EXPECT(checker.UpdateObject(8, nullptr, previous_tracking_id, absent_frames) == TemporalConsistencyChecker::kObjectNew);
+  EXPECT(checker.GetStatistics().id_changes == 1);
+}
+
+void TestDuplicateId()
+{
+  TemporalConsistencyChecker checker;
+  checker.Configure(16, kMaxAbsentFrames);
+  checker.BeginFrame(0.1);
+  uint64_t previous_tracking_id = 0;
+  uint64_t absent_frames = 0;
+  EXPECT(checker.UpdateObject(1, nullptr, previous_tracking_id, absent_frames) == TemporalConsistencyChecker::kObjectNew);
+  EXPECT(checker.UpdateObject(1, nullptr, previous_tracking_id, absent_frames) == TemporalConsistencyChecker::kObjectDuplicate);
+  EXPECT(checker.GetStatistics().duplicate_ids == 1);
+}
+
+/* Equal and decreasing timestamps are violations, frames without timestamp are skipped by the comparison but count for the ids */
+void TestTimestamps()
+{
+  TemporalConsistencyChecker checker;
+  checker.Configure(16, kMaxAbsentFrames);
+  EXPECT(checker.BeginFrame(1.0));
+  EXPECT(checker.BeginFrame(1.1));
+  EXPECT(!checker.BeginFrame(1.1));
+  EXPECT(!checker.BeginFrame(0.5));
+  EXPECT(checker.GetStatistics().timestamp_violations == 2);
+  EXPECT(checker.BeginFrame(0.6));  // compared to the last timestamp, not the largest one
+
+  checker.BeginFrame();
+  EXPECT(checker.LastTimestamp() == 0.6);
+  EXPECT(checker.BeginFrame(0.7));
+  checker.BeginFrame();
+  EXPECT(!checker.BeginFrame(0.7));
+  EXPECT(checker.GetStatistics().timestamp_violations == 3);
+  EXPECT(checker.GetStatistics().frames == 9);
+}
+
+/* An id present in frames without timestamp is not absent in them */
+void TestFramesWithoutTimestamp()
+{
+  TemporalConsistencyChecker checker;
+  checker.Configure(16, kMaxAbsentFrames);
+  double timestamp = 0.0;
+  EXPECT(Frame(checker, timestamp += 0.1, {{1, 101}}).empty());
+  for (uint32_t frame = 0; frame <= kMaxAbsentFrames + 1; frame++)
+  {
+    checker.BeginFrame();
+    uint64_t previous_tracking_id = 0;
+    uint64_t absent_frames = 0;
+    const uint64_t first_object = 101;
+    EXPECT(checker.UpdateObject(1, &first_object, previous_tracking_id, absent_frames) != TemporalConsistencyChecker::kObjectNew);
+    EXPECT(absent_frames == 0);
+    checker.EndFrame();
+  }
+  EXPECT(Frame(checker, timestamp += 0.1, {{1, 101}}).empty());
+  EXPECT(checker.GetStatistics().gap_violations == 0);
+  EXPECT(checker.GetStatistics().timestamp_violations == 0);
+}
+
+/* Ids that left long ago make room for new ones without a warning, ids that may still come back are counted when evicted */
+void TestEviction()
+{
+  TemporalConsistencyChecker checker;
+  checker.Configure(4, kMaxAbsentFrames);
+  double timestamp = 0.0;
+  for (uint64_t id = 1; id <= 100; id++)
+  {
+    EXPECT(Frame(checker, timestamp += 0.1, {{id, 1000 + id}}).empty());
+  }
+  EXPECT(checker.GetStatistics().evictions == 0);
+  EXPECT(checker.GetStatistics().gap_violations == 0);
+
+  checker.Configure(4, kMaxAbsentFrames);
+  EXPECT(Frame(checker, timestamp += 0.1, {{1, 101}, {2, 102}, {3, 103}, {4, 104}}).empty());
+  EXPECT(Frame(checker, timestamp += 0.1, {{1, 101}, {2, 102}, {3, 103}, {4, 104}, {5, 105}}).empty());
+  EXPECT(checker.GetStatistics().evictions == 1);
+}
+
+}  // namespace
+
+int main()
+{
+  TestDepartingId();
+  TestFlickerBeyondLimit();
+  TestFlickerWithinLimit();
+  TestReplacedId();
+  TestDuplicateId();
+  TestEviction();
+  TestTimestamps();
+  TestFramesWithoutTimestamp();
+  return TestResult();
+}
@@ -0,0 +1,64 @@
+//
+// Copyright 2023 BMW AG
+// SPDX-License-Identifier: MPL-2.0
+//
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "osi_sensordata.pb.h"
+
+/*
+ * Synthetic SensorData frames for the trace tests.  Every 5th moving object
+ * lacks its velocity and every 50th its base polygon, every 10th lidar
+ * detection lacks its intensity, so a trace has field checks with low and
+ * with high fill rates.
+ */
+
+inline std::string TestFrame(int frame_index, int object_count = 20, int detection_count = 100)
+{
+  osi3::SensorData sensor_data;
+  sensor_data.mutable_timestamp()->set_seconds(frame_index);
+  for (int i = 0; i < object_count; i++)
+  {
+    const int object_index = frame_index * object_count + i;
+    osi3::BaseMoving* base = sensor_data.add_moving_object()->mutable_base();
+    base->mutable_dimension()->set_length(4.5);
+    base->mutable_position()->set_x(10.0 + i);
+    base->mutable_orientation()->set_yaw(0.1);
+    if (object_index % 5 != 3)
+    {
+      base->mutable_velocity()->set_x(1.0);
+    }
+    base->mutable_acceleration()->set_x(0.1);
+    base->mutable_orientation_rate()->set_yaw(0.0);
+    base->mutable_orientation_acceleration()->set_yaw(0.0);
+    if (object_index % 50 != 7)
+    {
+      base->add_base_polygon()->set_x(1.0);
+    }
+  }
+  osi3::LidarDetectionData* lidar_sensor = sensor_data.mutable_feature_data()->add_lidar_sensor();
+  for (int i = 0; i < detection_count; i++)
+  {
+    osi3::LidarDetection* detection = lidar_sensor->add_detection();
+    detection->mutable_position()->set_distance(1.0 + 0.01 * i);
+    detection->set_existence_probability(0.9);
+    if (i % 10 != 4)
+    {
+      detection->set_intensity(0.5);
+    }
+  }
+  return sensor_data.SerializeAsString();
+}
+
+/* A frame of a binary OSI trace, preceded by its size as 32 bit little-endian integer */
+inline std::string TraceRecord(const std::string& frame)
+{
+  const auto size = static_cast<uint32_t>(frame.size());
+  const char prefix[4] = {static_cast<char>(size & 0xFFU), static_cast<char>((size >> 8U) & 0xFFU), static_cast<char>((size >> 16U) & 0xFFU),
+                          static_cast<char>((size >> 24U) & 0xFFU)};
+  return std::string(prefix, sizeof(prefix)) + frame;
+}
@@ -0,0 +1,175 @@
+//
+// Copyright 2023 BMW AG
+// SPDX-License-Identifier: MPL-2.0
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "Expect.h"
+#include "TestTrace.h"
+#include "TraceStream.h"
+
+namespace
+{
+
+/* Larger than the input buffer of TraceStream, so reading and decompressing span several buffers */
+const int kFrameCount = 300;
+
+std::vector<std::string> Frames()
+{
+  std::vector<std::string> frames;
+  for (int i = 0; i < kFrameCount; i++)
+  {
+    frames.push_back(TestFrame(i, 20, 200));
+  }
+  return frames;
+}
+
+std::string Trace(const std::vector<std::string>& frames)
+{
+  std::string trace;
+  for (const auto& frame : frames)
+  {
+    trace += TraceRecord(frame);
+  }
+  return trace;
+}
+
+void WriteFile(const std::string& path, const std::string& content)
+{
+  std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+  file.write(content.data(), static_cast<std::streamsize>(content.size()));
+}
+
+/* Reads the trace until it ends and removes it, returns the frames read, error receives Error() */
+std::vector<std::string> ReadTrace(const std::string& path, TraceStream::Compression compression, std::string& error)
+{
+  std::vector<std::string> frames;
+  error.clear();
+  {
+    TraceStream trace;
+    if (trace.Open(path, error))
+    {
+      EXPECT(trace.GetCompression() == compression);
+      std::string frame;
+      while (trace.ReadFrame(frame))
+      {
+        frames.push_back(frame);
+      }
+      error = trace.Error();
+    }
+  }
+  std::remove(path.c_str());
+  return frames;
+}
+
+/* The complete file gives all frames, the file cut in the middle gives the frames before the cut and an error */
+void TestRoundTrip(const std::string& path, const std::string& file, TraceStream::Compression compression)
+{
+  const std::vector<std::string> frames = Frames();
+  std::string error;
+  WriteFile(path, file);
+  EXPECT(ReadTrace(path, compression, error) == frames);
+  EXPECT(error.empty());
+
+  WriteFile(path, file.substr(0, file.size() / 2));
+  const std::vector<std::string> truncated_frames = ReadTrace(path, compression, error);
+  EXPECT(!truncated_frames.empty() && truncated_frames.size() < frames.size());
+  EXPECT(std::vector<std::string>(frames.begin(), frames.begin() + static_cast<std::ptrdiff_t>(truncated_frames.size())) == truncated_frames);
+  EXPECT(!error.empty());
+}
+
+void TestUncompressed()
+{
+  const std::string trace = Trace(Frames());
+  TestRoundTrip("TestTraceStream.osi", trace, TraceStream::kUncompressed);
+
+  /* Cut within a size prefix */
+  std::string error;
+  WriteFile("TestTraceStream.osi", trace.substr(0, TraceRecord(Frames()[0]).size() + 2));
+  EXPECT(ReadTrace("TestTraceStream.osi", TraceStream::kUncompressed, error).size() == 1);
+  EXPECT(error == "trace ends within the size of a frame");
+
+  WriteFile("TestTraceStream.osi", "");
+  EXPECT(ReadTrace("TestTraceStream.osi", TraceStream::kUncompressed, error).empty());
+  EXPECT(error.empty());
+}
+
+#ifdef HAVE_LZ4
+std::string CompressLz4(const std::string& data)
+{
+  std::string compressed(LZ4F_compressFrameBound(data.size(), nullptr), '\0');
+  const size_t size = LZ4F_compressFrame(&compressed[0], compressed.size(), data.data(), data.size(), nullptr);
+  EXPECT(!LZ4F_isError(size));
+  compressed.resize(LZ4F_isError(size) ? 0 : size);
+  return compressed;
+}
+
+void TestLz4()
+{
+  const std::string trace = Trace(Frames());
+  TestRoundTrip("TestTraceStream.osi.lz4", CompressLz4(trace), TraceStream::kLz4);
+
+  /* Concatenated compressed frames, split within a trace frame */
+  std::string error;
+  WriteFile("TestTraceStream.osi.lz4", CompressLz4(trace.substr(0, trace.size() / 3)) + CompressLz4(trace.substr(trace.size() / 3)));
+  EXPECT(ReadTrace("TestTraceStream.osi.lz4", TraceStream::kLz4, error) == Frames());
+  EXPECT(error.empty());
+}
+#endif
+
+#ifdef HAVE_ZSTD
+std::string CompressZstd(const std::string& data)
+{
+  std::string compressed(ZSTD_compressBound(data.size()), '\0');
+  const size_t size = ZSTD_compress(&compressed[0], compressed.size(), data.data(), data.size(), 3);
+  EXPECT(!ZSTD_isError(size));
+  compressed.resize(ZSTD_isError(size) ? 0 : size);
+  return compressed;
+}
+
+void TestZstd()
+{
+  const std::string trace = Trace(Frames());
+  TestRoundTrip("TestTraceStream.osi.zst", CompressZstd(trace), TraceStream::kZstd);
+
+  std::string error;
+  WriteFile("TestTraceStream.osi.zst", CompressZstd(trace.substr(0, trace.size() / 3)) + CompressZstd(trace.substr(trace.size() / 3)));
+  EXPECT(ReadTrace("TestTraceStream.osi.zst", TraceStream::kZstd, error) == Frames());
+  EXPECT(error.empty());
+}
+#endif
+
+#if !defined(HAVE_LZ4) || !defined(HAVE_ZSTD)
+/* Without the library, a compressed trace is rejected when it is opened */
+void TestUnsupported(const std::string& path, const std::string& magic)
+{
+  WriteFile(path, magic + std::string(64, '\0'));
+  std::string error;
+  EXPECT(ReadTrace(path, TraceStream::kUncompressed, error).empty());
+  EXPECT(error.find("was not found when building") != std::string::npos);
+}
+#endif
+
+}  // namespace
+
+int main()
+{
+  TestUncompressed();
+#ifdef HAVE_LZ4
+  TestLz4();
+#else
+  TestUnsupported("TestTraceStream.osi.lz4", std::string("\x04\x22\x4d\x18", 4));
+#endif
+#ifdef HAVE_ZSTD
+  TestZstd();
+#else
+  TestUnsupported("TestTraceStream.osi.zst", std::string("\x28\xb5\x2f\xfd", 4));
+#endif
+  return TestResult();
+}
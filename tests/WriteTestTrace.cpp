@@ -0,0 +1,33 @@
+//
+// Copyright 2023 BMW AG
+// SPDX-License-Identifier: MPL-2.0
+//
+
+/*
+ * Writes an uncompressed binary OSI trace of the frames of TestTrace.h for
+ * the tests of the Python bindings.
+ *
+ * Usage: WriteTestTrace <trace.osi> [frames=20]
+ */
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+#include "TestTrace.h"
+
+int main(int argc, char** argv)
+{
+  const int frame_count = (argc > 2) ? std::atoi(argv[2]) : 20;
+  if (argc < 2 || argc > 3 || frame_count < 0)
+  {
+    std::cerr << "Usage: " << argv[0] << " <trace.osi> [frames]" << std::endl;
+    return 2;
+  }
+  std::ofstream trace(argv[1], std::ios::out | std::ios::binary | std::ios::trunc);
+  for (int i = 0; i < frame_count; i++)
+  {
+    trace << TraceRecord(TestFrame(i));
+  }
+  return trace.good() ? 0 : 1;
+}